@@ -260,7 +260,7 @@ void process_player(PlayerType *player_ptr)
         handle_stuff(player_ptr);
         move_cursor_relative(player_ptr->y, player_ptr->x);
         if (fresh_before) {
-            term_fresh_force();
+            term_fresh_scheduled();
         }
 
         pack_overflow(player_ptr);
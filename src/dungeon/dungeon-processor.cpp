@@ -7,6 +7,7 @@
 #include "core/turn-compensator.h"
 #include "core/window-redrawer.h"
 #include "dungeon/quest.h"
+#include "floor/floor-generation-worker.h"
 #include "floor/floor-leaver.h"
 #include "floor/floor-save-util.h"
 #include "floor/floor-save.h"
@@ -234,7 +235,7 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
 
         move_cursor_relative(player_ptr->y, player_ptr->x);
         if (fresh_after) {
-            term_fresh_force();
+            term_fresh_scheduled();
         }
 
         if (!player_ptr->playing || player_ptr->is_dead) {
@@ -246,7 +247,7 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
 
         move_cursor_relative(player_ptr->y, player_ptr->x);
         if (fresh_after) {
-            term_fresh_force();
+            term_fresh_scheduled();
         }
 
         if (!player_ptr->playing || player_ptr->is_dead) {
@@ -258,7 +259,7 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
 
         move_cursor_relative(player_ptr->y, player_ptr->x);
         if (fresh_after) {
-            term_fresh_force();
+            term_fresh_scheduled();
         }
 
         if (!player_ptr->playing || player_ptr->is_dead) {
@@ -281,6 +282,8 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
             break;
         }
 
+        update_next_floor_generation(player_ptr);
+
         if (wild_regen) {
             wild_regen--;
         }
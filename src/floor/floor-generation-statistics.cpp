@@ -0,0 +1,84 @@
+#include "floor/floor-generation-statistics.h"
+#include "room/room-types.h"
+
+FloorGenerationStatistics FloorGenerationStatistics::instance{};
+
+FloorGenerationStatistics &FloorGenerationStatistics::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 新しいフロアの生成を開始する
+ */
+void FloorGenerationStatistics::begin_floor()
+{
+    this->retries.clear();
+    this->begin_attempt();
+}
+
+/*!
+ * @brief フロア生成の新しい試行を開始する
+ * @details 部屋と固定部屋は採用された試行のものだけを残すため、試行毎に消去する.
+ */
+void FloorGenerationStatistics::begin_attempt()
+{
+    this->rooms.clear();
+    this->vaults.clear();
+}
+
+/*!
+ * @brief 再生成を記録する
+ * @param reason 再生成の理由
+ */
+void FloorGenerationStatistics::add_retry(std::string_view reason)
+{
+    this->retries[std::string(reason)]++;
+}
+
+/*!
+ * @brief 生成した部屋を記録する
+ * @param room_type 部屋の種類
+ */
+void FloorGenerationStatistics::add_room(RoomType room_type)
+{
+    this->rooms[room_type]++;
+}
+
+/*!
+ * @brief 生成した固定部屋を記録する
+ * @param name 固定部屋の名前
+ */
+void FloorGenerationStatistics::add_vault(std::string_view name)
+{
+    this->vaults.emplace_back(name);
+}
+
+/*!
+ * @brief 再生成の総回数を返す
+ * @return 再生成の総回数
+ */
+int FloorGenerationStatistics::get_retry_count() const
+{
+    auto count = 0;
+    for (const auto &[reason, num] : this->retries) {
+        count += num;
+    }
+
+    return count;
+}
+
+const std::map<std::string, int> &FloorGenerationStatistics::get_retries() const
+{
+    return this->retries;
+}
+
+const std::map<RoomType, int> &FloorGenerationStatistics::get_rooms() const
+{
+    return this->rooms;
+}
+
+const std::vector<std::string> &FloorGenerationStatistics::get_vaults() const
+{
+    return this->vaults;
+}
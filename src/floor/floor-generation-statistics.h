@@ -0,0 +1,40 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class RoomType;
+
+/*!
+ * @brief フロア生成の統計情報
+ * @details 直前に生成したフロアについて、再生成の理由毎の回数と、採用した試行で生成した部屋/固定部屋を記録する.
+ */
+class FloorGenerationStatistics {
+public:
+    FloorGenerationStatistics(const FloorGenerationStatistics &) = delete;
+    FloorGenerationStatistics(FloorGenerationStatistics &&) = delete;
+    FloorGenerationStatistics &operator=(const FloorGenerationStatistics &) = delete;
+    FloorGenerationStatistics &operator=(FloorGenerationStatistics &&) = delete;
+    static FloorGenerationStatistics &get_instance();
+
+    void begin_floor();
+    void begin_attempt();
+    void add_retry(std::string_view reason);
+    void add_room(RoomType room_type);
+    void add_vault(std::string_view name);
+
+    int get_retry_count() const;
+    const std::map<std::string, int> &get_retries() const;
+    const std::map<RoomType, int> &get_rooms() const;
+    const std::vector<std::string> &get_vaults() const;
+
+private:
+    FloorGenerationStatistics() = default;
+
+    static FloorGenerationStatistics instance;
+    std::map<std::string, int> retries; //!< 再生成の理由毎の回数
+    std::map<RoomType, int> rooms; //!< 部屋の種類毎の生成数
+    std::vector<std::string> vaults; //!< 生成した固定部屋の名前
+};
@@ -0,0 +1,546 @@
+/*!
+ * @file floor-generation-worker.cpp
+ * @brief 子プロセスでのフロア生成の実装
+ * @details
+ * 子プロセスはゲームの状態を引き継いでフロアの生成を試行し、生成したフロアを一時保存フロアと同じ形式で親プロセスに送る.
+ * 親プロセスは子プロセスが表示するはずだったメッセージと生成統計を再現してからフロアを読み込む.
+ * プレイヤーが階段の上にいる間は、その階段の先のフロアも子プロセスで先に生成しておく.
+ * fork できない環境では何もせず、呼び出し元で順に生成させる.
+ */
+
+#include "floor/floor-generation-worker.h"
+#ifndef WINDOWS
+#include "floor/floor-generation-statistics.h"
+#include "dungeon/quest.h"
+#include "floor/floor-generator.h"
+#include "floor/floor-save.h"
+#include "floor/floor-util.h"
+#include "floor/wild.h"
+#include "game-option/game-play-options.h"
+#include "load/floor-loader.h"
+#include "load/load-util.h"
+#include "locale/character-encoding.h"
+#include "main-unix/forked-task.h"
+#include "monster-floor/monster-remover.h"
+#include "monster-race/race-kind-flags.h"
+#include "monster-race/race-population-flags.h"
+#include "room/room-types.h"
+#include "save/floor-writer.h"
+#include "save/save-util.h"
+#include "system/angband-system.h"
+#include "system/angband-version.h"
+#include "system/artifact-type-definition.h"
+#include "system/dungeon-info.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include "system/monster-entity.h"
+#include "system/monster-race-info.h"
+#include "system/player-type-definition.h"
+#include "system/terrain-type-definition.h"
+#include "util/enum-converter.h"
+#include "util/finalizer.h"
+#include "util/point-2d.h"
+#include "view/display-messages.h"
+#include "window/main-window-util.h"
+#include "world/world.h"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/*!
+ * @brief 子プロセスでのフロア生成の結果
+ */
+struct FloorGenerationResult {
+    uint32_t floor_seed = 0; //!< 生成に用いたシード
+    bool is_generated = false; //!< フロアの生成に成功したか
+    DeferredMessages messages; //!< 生成中に表示するはずだったメッセージ
+    std::map<std::string, int> retries; //!< 再生成の理由毎の回数
+    std::map<RoomType, int> rooms; //!< 採用した試行で生成した部屋の種類毎の数
+    std::vector<std::string> vaults; //!< 採用した試行で生成した固定部屋の名前
+    std::vector<FixedArtifactId> artifacts; //!< 採用した試行で生成した固定アーティファクト
+};
+
+/*!
+ * @brief 先に生成している次のフロアの行き先
+ */
+struct NextFloorKey {
+    short dungeon_idx = 0; //!< ダンジョンID
+    int dun_level = 0; //!< 行き先の階
+    short floor_id = 0; //!< 階段のあるフロアのID
+    Pos2D pos = { 0, 0 }; //!< 階段の座標
+
+    bool operator==(const NextFloorKey &other) const = default;
+};
+
+std::unique_ptr<ForkedTask> next_floor_task; //!< 次のフロアを生成している子プロセス
+NextFloorKey next_floor_key; //!< next_floor_task の行き先
+
+/*!
+ * @brief 子プロセスでフロアの生成を試行し、結果をバイト列にする
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param floor_seed フロア毎にゲームの乱数から得たシード
+ * @param num_begin 最初の試行回数
+ * @param num_end 試行回数の上限
+ * @return 結果のバイト列. 生成に成功した場合は末尾にフロアを含む
+ */
+std::vector<byte> generate_floor_in_child(PlayerType *player_ptr, uint32_t floor_seed, int num_begin, int num_end)
+{
+    DeferredMessages messages;
+    msg_defer(&messages);
+    if (num_begin > 0) {
+        // 先行する試行が失敗した後の後始末を再現する
+        wipe_o_list(player_ptr->current_floor_ptr);
+        wipe_monsters_list(player_ptr);
+    }
+
+    const auto &artifacts = ArtifactList::get_instance();
+    std::set<FixedArtifactId> generated_artifacts;
+    for (const auto &[fa_id, artifact] : artifacts) {
+        if (artifact.is_generated) {
+            generated_artifacts.insert(fa_id);
+        }
+    }
+
+    auto &statistics = FloorGenerationStatistics::get_instance();
+    statistics.begin_floor();
+    const auto is_generated = generate_floor_attempts(player_ptr, floor_seed, num_begin, num_end);
+    msg_defer(nullptr);
+
+    saving_savedata.clear();
+    save_xor_byte = 0;
+    wr_u32b(floor_seed);
+    wr_bool(is_generated);
+    wr_u32b(static_cast<uint32_t>(messages.size()));
+    for (const auto &message : messages) {
+        wr_bool(message.has_value());
+        if (message) {
+            wr_string(*message);
+        }
+    }
+
+    wr_u16b(static_cast<uint16_t>(statistics.get_retries().size()));
+    for (const auto &[reason, count] : statistics.get_retries()) {
+        wr_string(reason);
+        wr_s32b(count);
+    }
+
+    if (!is_generated) {
+        return std::move(saving_savedata);
+    }
+
+    wr_u16b(static_cast<uint16_t>(statistics.get_rooms().size()));
+    for (const auto &[room_type, count] : statistics.get_rooms()) {
+        wr_byte(static_cast<byte>(enum2i(room_type)));
+        wr_s32b(count);
+    }
+
+    wr_u16b(static_cast<uint16_t>(statistics.get_vaults().size()));
+    for (const auto &name : statistics.get_vaults()) {
+        wr_string(name);
+    }
+
+    std::vector<FixedArtifactId> new_artifacts;
+    for (const auto &[fa_id, artifact] : artifacts) {
+        if (artifact.is_generated && !generated_artifacts.contains(fa_id)) {
+            new_artifacts.push_back(fa_id);
+        }
+    }
+
+    wr_u16b(static_cast<uint16_t>(new_artifacts.size()));
+    for (const auto fa_id : new_artifacts) {
+        wr_s16b(enum2i(fa_id));
+    }
+
+    wr_saved_floor(player_ptr, nullptr);
+    return std::move(saving_savedata);
+}
+
+/*!
+ * @brief 子プロセスから受け取った結果を読み込む
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param bytes 結果のバイト列
+ * @return 結果. 壊れていた場合はstd::nullopt
+ * @details 生成に成功していた場合、フロアを現在のフロアに読み込む. 統計やメッセージはまだ反映しない.
+ */
+std::optional<FloorGenerationResult> read_floor_generation_result(PlayerType *player_ptr, std::vector<byte> &&bytes)
+{
+    auto &system = AngbandSystem::get_instance();
+    const auto finalizer = util::make_finalizer([savedata = std::move(loading_savedata), savedata_pos = loading_savedata_pos, xor_byte = load_xor_byte,
+                                                    old_v_check = v_check, old_x_check = x_check, version = system.get_version(),
+                                                    savefile_version = loading_savefile_version, encoding = loading_character_encoding]() mutable {
+        loading_savedata = std::move(savedata);
+        loading_savedata_pos = savedata_pos;
+        load_xor_byte = xor_byte;
+        v_check = old_v_check;
+        x_check = old_x_check;
+        AngbandSystem::get_instance().set_version(version);
+        loading_savefile_version = savefile_version;
+        loading_character_encoding = encoding;
+    });
+
+    const auto size = bytes.size();
+    loading_savedata = std::move(bytes);
+    loading_savedata_pos = 0;
+    load_xor_byte = 0;
+    system.set_version({ H_VER_MAJOR, H_VER_MINOR, H_VER_PATCH, H_VER_EXTRA });
+    loading_savefile_version = SAVEFILE_VERSION;
+    loading_character_encoding = CharacterEncoding::UNKNOWN;
+
+    FloorGenerationResult result;
+    result.floor_seed = rd_u32b();
+    result.is_generated = rd_bool();
+    const auto num_messages = rd_u32b();
+    if (num_messages > size) {
+        return std::nullopt;
+    }
+
+    for (auto i = 0U; i < num_messages; i++) {
+        if (rd_bool()) {
+            result.messages.emplace_back(rd_string());
+        } else {
+            result.messages.push_back(std::nullopt);
+        }
+    }
+
+    const auto num_retries = rd_u16b();
+    for (auto i = 0; i < num_retries; i++) {
+        auto reason = rd_string();
+        result.retries[reason] = rd_s32b();
+    }
+
+    if (result.is_generated) {
+        const auto num_rooms = rd_u16b();
+        for (auto i = 0; i < num_rooms; i++) {
+            const auto room_type = i2enum<RoomType>(rd_byte());
+            result.rooms[room_type] = rd_s32b();
+        }
+
+        const auto num_vaults = rd_u16b();
+        for (auto i = 0; i < num_vaults; i++) {
+            result.vaults.push_back(rd_string());
+        }
+
+        const auto num_artifacts = rd_u16b();
+        for (auto i = 0; i < num_artifacts; i++) {
+            result.artifacts.push_back(i2enum<FixedArtifactId>(rd_s16b()));
+        }
+
+        if (rd_saved_floor(player_ptr, nullptr)) {
+            return std::nullopt;
+        }
+    }
+
+    if (loading_savedata_pos != size) {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+/*!
+ * @brief 子プロセスでの生成結果をゲームに反映する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param result 生成結果
+ */
+void apply_floor_generation_result(PlayerType *player_ptr, const FloorGenerationResult &result)
+{
+    msg_print_deferred(result.messages);
+    auto &statistics = FloorGenerationStatistics::get_instance();
+    for (const auto &[reason, count] : result.retries) {
+        for (auto i = 0; i < count; i++) {
+            statistics.add_retry(reason);
+        }
+    }
+
+    if (!result.is_generated) {
+        return;
+    }
+
+    statistics.begin_attempt();
+    for (const auto &[room_type, count] : result.rooms) {
+        for (auto i = 0; i < count; i++) {
+            statistics.add_room(room_type);
+        }
+    }
+
+    for (const auto &name : result.vaults) {
+        statistics.add_vault(name);
+    }
+
+    auto &artifacts = ArtifactList::get_instance();
+    for (const auto fa_id : result.artifacts) {
+        artifacts.get_artifact(fa_id).is_generated = true;
+    }
+
+    auto &floor = *player_ptr->current_floor_ptr;
+    floor.reset_mproc();
+    panel_row_min = floor.height;
+    panel_col_min = floor.width;
+}
+
+/*!
+ * @brief 現在のフロアの生成が子プロセスで行えるかを返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 行えるか否か
+ * @details
+ * ゲーム中の状態 (ユニークの所在など) を書き換えず、各試行の結果がシードと試行回数だけで決まるランダムフロアに限る.
+ */
+bool can_generate_floor_in_child(PlayerType *player_ptr)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    auto can_generate = !AngbandWorld::get_instance().character_dungeon;
+    can_generate &= floor.is_in_underground() && !floor.is_in_quest() && !floor.inside_arena;
+    can_generate &= !AngbandSystem::get_instance().is_phase_out();
+    return can_generate;
+}
+
+/*!
+ * @brief プレイヤーのいる階段の先のフロアを返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 行き先. 先に生成できない場合はstd::nullopt
+ * @details
+ * 行き先がランダムフロアになる階段に限る. 一度通った階段の先は保存フロアを読み込むので生成しない.
+ */
+std::optional<NextFloorKey> get_next_floor_key(PlayerType *player_ptr)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    auto can_pregenerate = pregenerate_next_floor && AngbandWorld::get_instance().character_dungeon;
+    can_pregenerate &= floor.is_in_underground() && !floor.is_in_quest() && !floor.inside_arena;
+    can_pregenerate &= !AngbandSystem::get_instance().is_phase_out();
+    if (!can_pregenerate) {
+        return std::nullopt;
+    }
+
+    const auto p_pos = player_ptr->get_position();
+    const auto &grid = floor.get_grid(p_pos);
+    const auto &terrain = grid.get_terrain();
+    if (terrain.flags.has_any_of({ TerrainCharacteristics::QUEST, TerrainCharacteristics::QUEST_ENTER, TerrainCharacteristics::QUEST_EXIT })) {
+        return std::nullopt;
+    }
+
+    auto move_num = 0;
+    if (terrain.flags.has(TerrainCharacteristics::MORE)) {
+        move_num = 1;
+    } else if (terrain.flags.has(TerrainCharacteristics::LESS)) {
+        move_num = -1;
+    } else {
+        return std::nullopt;
+    }
+
+    if (terrain.flags.has(TerrainCharacteristics::SHAFT)) {
+        move_num *= 2;
+    }
+
+    if (grid.special && terrain.flags.has_not(TerrainCharacteristics::SPECIAL) && get_sf_ptr(grid.special)) {
+        return std::nullopt;
+    }
+
+    const auto &dungeon = floor.get_dungeon_definition();
+    const auto dun_level = floor.dun_level + move_num;
+    if ((dun_level < dungeon.mindepth) || (dun_level > dungeon.maxdepth) || inside_quest(floor.get_quest_id(move_num))) {
+        return std::nullopt;
+    }
+
+    return NextFloorKey{ floor.dungeon_idx, dun_level, player_ptr->floor_id, p_pos };
+}
+
+/*!
+ * @brief 子プロセスで現在のフロアを離れ、次のフロアを生成する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param dun_level 次のフロアの階
+ * @return 結果のバイト列
+ * @details 親プロセスが次に generate_floor() で得るシードと同じシードで生成する.
+ */
+std::vector<byte> generate_next_floor_in_child(PlayerType *player_ptr, int dun_level)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    wipe_o_list(&floor);
+    wipe_monsters_list(player_ptr);
+    AngbandWorld::get_instance().character_dungeon = false;
+    floor.dun_level = dun_level;
+    set_floor_and_wall(floor.dungeon_idx);
+    const auto floor_seed = AngbandSystem::get_instance().get_rng_stream(RngStream::FLOOR_GENERATION)();
+    return generate_floor_in_child(player_ptr, floor_seed, 0, std::numeric_limits<int>::max());
+}
+
+/*!
+ * @brief 先に生成したフロアが現在のゲームの状態と矛盾しないかを返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param result 読み込んだ生成結果
+ * @return 矛盾しないか否か
+ * @details
+ * 生成を始めた後にユニークを倒したり固定アーティファクトを見つけたりしていると、同じものが2つ存在してしまう.
+ * 連れて行くペットの数は読み込む前に数えてあるので、ペットのユニークと重複した場合もここで弾く.
+ */
+bool is_consistent_with_game(PlayerType *player_ptr, const FloorGenerationResult &result)
+{
+    const auto &artifacts = ArtifactList::get_instance();
+    for (const auto fa_id : result.artifacts) {
+        if (artifacts.get_artifact(fa_id).is_generated) {
+            return false;
+        }
+    }
+
+    const auto &floor = *player_ptr->current_floor_ptr;
+    for (auto i = 1; i < floor.m_max; i++) {
+        const auto &monster = floor.m_list[i];
+        if (!monster.is_valid()) {
+            continue;
+        }
+
+        const auto &monrace = monster.get_real_monrace();
+        auto is_unique = monrace.kind_flags.has(MonsterKindType::UNIQUE) || monrace.population_flags.has(MonsterPopulationType::NAZGUL);
+        is_unique &= monrace.cur_num > monrace.max_num;
+        if (is_unique || (monrace.population_flags.has(MonsterPopulationType::ONLY_ONE) && (monrace.cur_num > 1))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+}
+#endif
+
+/*!
+ * @brief フロア生成の試行を子プロセスで並行して行う
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param floor_seed フロア毎にゲームの乱数から得たシード
+ * @param num 失敗した試行の数を返す. 続きを順に生成する際の最初の試行回数になる
+ * @return フロアを生成できたか否か
+ * @details
+ * 試行毎に子プロセスを fork し、先頭から順に結果を待って最初に成功した試行を採用する.
+ * 失敗した試行の後始末は親プロセスでも順に行うので、採用する試行と生成後の状態は順に生成した場合と同じになる.
+ * オプションが無効な場合や子プロセスで生成できないフロアでは何もしない.
+ */
+bool generate_floor_in_parallel(PlayerType *player_ptr, uint32_t floor_seed, int *num)
+{
+    *num = 0;
+#ifdef WINDOWS
+    (void)player_ptr;
+    (void)floor_seed;
+    return false;
+#else
+    if (!parallel_floor_generation || !can_generate_floor_in_child(player_ptr)) {
+        return false;
+    }
+
+    const auto max_tasks = static_cast<int>(std::max(2U, std::thread::hardware_concurrency()));
+    std::deque<std::unique_ptr<ForkedTask>> tasks;
+    auto next_num = 0;
+    clear_cave(player_ptr);
+    player_ptr->x = player_ptr->y = 0;
+    while (*num < MAX_FLOOR_CONNECTION_ATTEMPTS) {
+        while ((std::ssize(tasks) < max_tasks) && (next_num < MAX_FLOOR_CONNECTION_ATTEMPTS)) {
+            auto task = ForkedTask::start([player_ptr, floor_seed, next_num] {
+                return generate_floor_in_child(player_ptr, floor_seed, next_num, next_num + 1);
+            });
+            if (!task) {
+                break;
+            }
+
+            tasks.push_back(std::move(task));
+            next_num++;
+        }
+
+        if (tasks.empty()) {
+            return false;
+        }
+
+        auto bytes = tasks.front()->wait();
+        tasks.pop_front();
+        const auto result = bytes ? read_floor_generation_result(player_ptr, std::move(*bytes)) : std::nullopt;
+        if (!result || (result->floor_seed != floor_seed)) {
+            return false;
+        }
+
+        apply_floor_generation_result(player_ptr, *result);
+        if (result->is_generated) {
+            return true;
+        }
+
+        wipe_o_list(player_ptr->current_floor_ptr);
+        wipe_monsters_list(player_ptr);
+        (*num)++;
+    }
+
+    return false;
+#endif
+}
+
+/*!
+ * @brief プレイヤーのいる階段の先のフロアを子プロセスで生成しておく
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details
+ * ゲームターン毎に呼ぶ. 階段に乗ると生成を始め、乗っている間は結果を受け取り続ける.
+ * 階段を離れたりオプションを無効にしたりすると子プロセスを止める.
+ */
+void update_next_floor_generation(PlayerType *player_ptr)
+{
+#ifdef WINDOWS
+    (void)player_ptr;
+#else
+    const auto key = get_next_floor_key(player_ptr);
+    if (!key) {
+        next_floor_task.reset();
+        return;
+    }
+
+    if (next_floor_task && (*key == next_floor_key)) {
+        (void)next_floor_task->poll();
+        return;
+    }
+
+    next_floor_key = *key;
+    next_floor_task = ForkedTask::start([player_ptr, dun_level = key->dun_level] {
+        return generate_next_floor_in_child(player_ptr, dun_level);
+    });
+#endif
+}
+
+/*!
+ * @brief 先に生成しておいたフロアを現在のフロアにする
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param floor_seed フロア毎にゲームの乱数から得たシード
+ * @return 先に生成しておいたフロアを使えたか否か
+ * @details
+ * 生成が終わっていなければ待つ. 行き先やシードが異なる場合や、生成後にゲームの状態が変わって矛盾する場合は使わない.
+ * 使わなかった場合も子プロセスは破棄するので、呼び出し元でフロアを生成し直すこと.
+ */
+bool commit_next_floor_generation(PlayerType *player_ptr, uint32_t floor_seed)
+{
+#ifdef WINDOWS
+    (void)player_ptr;
+    (void)floor_seed;
+    return false;
+#else
+    const auto task = std::move(next_floor_task);
+    const auto &floor = *player_ptr->current_floor_ptr;
+    auto can_commit = task && can_generate_floor_in_child(player_ptr);
+    can_commit &= (floor.dungeon_idx == next_floor_key.dungeon_idx) && (floor.dun_level == next_floor_key.dun_level);
+    if (!can_commit) {
+        return false;
+    }
+
+    auto bytes = task->wait();
+    if (!bytes) {
+        return false;
+    }
+
+    clear_cave(player_ptr);
+    player_ptr->x = player_ptr->y = 0;
+    const auto result = read_floor_generation_result(player_ptr, std::move(*bytes));
+    if (!result || (result->floor_seed != floor_seed) || !result->is_generated || !is_consistent_with_game(player_ptr, *result)) {
+        return false;
+    }
+
+    apply_floor_generation_result(player_ptr, *result);
+    return true;
+#endif
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+class PlayerType;
+bool generate_floor_in_parallel(PlayerType *player_ptr, uint32_t floor_seed, int *num);
+void update_next_floor_generation(PlayerType *player_ptr);
+bool commit_next_floor_generation(PlayerType *player_ptr, uint32_t floor_seed);
@@ -14,6 +14,8 @@
 #include "dungeon/quest.h"
 #include "floor/cave-generator.h"
 #include "floor/floor-events.h"
+#include "floor/floor-generation-statistics.h"
+#include "floor/floor-generation-worker.h"
 #include "floor/floor-generator.h"
 #include "floor/floor-save.h" //!< @todo precalc_cur_num_of_pet() が依存している、違和感.
 #include "floor/floor-util.h"
@@ -45,6 +47,7 @@
 #include "system/monster-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
+#include "system/rng-stream-guard.h"
 #include "system/terrain-type-definition.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
@@ -53,7 +56,9 @@
 #include "world/world.h"
 #include <algorithm>
 #include <array>
-#include <stack>
+#include <queue>
+#include <string>
+#include <vector>
 
 /*!
  * @brief 闘技場用のアリーナ地形を作成する / Builds the on_defeat_arena_monster after it is entered -KMW-
@@ -411,96 +416,223 @@ static bool is_permanent_blocker(const FloorType *const floor_ptr, const int y,
     return flags.has(TerrainCharacteristics::PERMANENT) && flags.has_not(TerrainCharacteristics::MOVE);
 }
 
-static void floor_is_connected_dfs(const FloorType *const floor_ptr, const IsWallFunc is_wall, const int y_start, const int x_start, bool *const visited)
+namespace {
+constexpr auto MAX_POCKET_SIZE = 100; //!< トンネルで接続する孤立領域の最大セル数
+constexpr auto MAX_POCKET_TUNNEL_LENGTH = 4; //!< 孤立領域を接続するトンネルの最大長
+
+// clang-format off
+constexpr std::array<int, 8> DY = { -1, -1, -1,  0, 0,  1, 1, 1 };
+constexpr std::array<int, 8> DX = { -1,  0,  1, -1, 1, -1, 0, 1 };
+// clang-format on
+
+/*!
+ * @brief フロアの連結成分
+ */
+struct FloorComponents {
+    int width = 0; //!< フロアの幅
+    std::vector<int> labels; //!< セル毎の連結成分番号 (壁は-1)
+    std::vector<int> sizes; //!< 連結成分毎のセル数
+};
+}
+
+/*!
+ * @brief Union-Findの代表元を経路を縮約しながら求める
+ * @param parents 各要素の親
+ * @param i 要素
+ * @return 代表元
+ */
+static int find_component_root(std::vector<int> &parents, int i)
 {
-    // clang-format off
-    static const int DY[8] = { -1, -1, -1,  0, 0,  1, 1, 1 };
-    static const int DX[8] = { -1,  0,  1, -1, 1, -1, 0, 1 };
-    // clang-format on
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+
+    return i;
+}
+
+/*!
+ * @brief フロアの連結成分を求める
+ * @param floor フロアへの参照
+ * @param is_wall 壁とみなすセルの判定関数
+ * @return 連結成分
+ * @details
+ * 各セルの8近傍は互いに移動可能とし、is_wall が真を返すセルのみを壁とみなす.
+ * フロアを1回走査し、走査済みの4近傍(左/左上/上/右上)とUnion-Findで併合した後、番号を振り直す.
+ */
+static FloorComponents label_floor_components(const FloorType &floor, const IsWallFunc is_wall)
+{
+    const int h = floor.height;
+    const int w = floor.width;
+    std::vector<int> parents(h * w, -1);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (is_wall(&floor, y, x)) {
+                continue;
+            }
+
+            const int idx = w * y + x;
+            parents[idx] = idx;
+            for (int i = 0; i < 4; ++i) {
+                const int y_adj = y + DY[i];
+                const int x_adj = x + DX[i];
+                if (y_adj < 0 || x_adj < 0 || w <= x_adj || parents[w * y_adj + x_adj] < 0) {
+                    continue;
+                }
+
+                const auto root_adj = find_component_root(parents, w * y_adj + x_adj);
+                const auto root = find_component_root(parents, idx);
+                parents[std::max(root, root_adj)] = std::min(root, root_adj);
+            }
+        }
+    }
 
-    const int h = floor_ptr->height;
-    const int w = floor_ptr->width;
-    const int start = w * y_start + x_start;
+    FloorComponents components{ w, std::vector<int>(h * w, -1), {} };
+    for (int idx = 0; idx < h * w; ++idx) {
+        if (parents[idx] < 0) {
+            continue;
+        }
 
-    // 深さ優先探索用のスタック。
-    // 最大フロアサイズが h=66, w=198 なので、スタックオーバーフロー防止のため再帰は使わない。
-    std::stack<int> stk;
+        // 代表元は成分内で最小の番号なので、走査順に現れた時点で新しい番号を振れる
+        const auto root = find_component_root(parents, idx);
+        if (root == idx) {
+            components.labels[idx] = static_cast<int>(components.sizes.size());
+            components.sizes.push_back(0);
+        } else {
+            components.labels[idx] = components.labels[root];
+        }
 
-    stk.emplace(start);
-    visited[start] = true;
+        components.sizes[components.labels[idx]]++;
+    }
 
-    while (!stk.empty()) {
-        const int cur = stk.top();
-        stk.pop();
-        const int y = cur / w;
-        const int x = cur % w;
+    return components;
+}
 
+/*!
+ * @brief 孤立した小さな領域から最大の連結成分までトンネルを掘る
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param components フロアの連結成分 (接続した領域は最大の連結成分に併合される)
+ * @param label 接続する連結成分の番号
+ * @param main_label 最大の連結成分の番号
+ * @return 接続できたか否か
+ * @details
+ * 孤立領域から壁のセルだけを通る幅優先探索で最大の連結成分への最短経路を求め、経路上の壁を床に変える.
+ * 外周と宝物庫の壁は掘らない.
+ */
+static bool tunnel_floor_pocket(PlayerType *player_ptr, FloorComponents &components, int label, int main_label)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    const int w = components.width;
+    const int h = floor.height;
+    std::vector<int> previous(h * w, -1);
+    std::vector<int> distances(h * w, -1);
+    std::queue<int> que;
+    for (int idx = 0; idx < h * w; ++idx) {
+        if (components.labels[idx] == label) {
+            distances[idx] = 0;
+            que.push(idx);
+        }
+    }
+
+    while (!que.empty()) {
+        const auto cur = que.front();
+        que.pop();
         for (int i = 0; i < 8; ++i) {
-            const int y_nxt = y + DY[i];
-            const int x_nxt = x + DX[i];
-            if (y_nxt < 0 || h <= y_nxt || x_nxt < 0 || w <= x_nxt) {
+            const int y_nxt = cur / w + DY[i];
+            const int x_nxt = cur % w + DX[i];
+            if (y_nxt <= 0 || h - 1 <= y_nxt || x_nxt <= 0 || w - 1 <= x_nxt) {
                 continue;
             }
+
             const int nxt = w * y_nxt + x_nxt;
-            if (visited[nxt]) {
-                continue;
+            if (components.labels[nxt] == main_label) {
+                for (auto idx = cur; distances[idx] > 0; idx = previous[idx]) {
+                    place_bold(player_ptr, idx / w, idx % w, GB_FLOOR);
+                    components.labels[idx] = main_label;
+                }
+
+                std::replace(components.labels.begin(), components.labels.end(), label, main_label);
+                return true;
             }
-            if (is_wall(floor_ptr, y_nxt, x_nxt)) {
+
+            if ((distances[nxt] >= 0) || (components.labels[nxt] >= 0) || (distances[cur] >= MAX_POCKET_TUNNEL_LENGTH) || floor.get_grid({ y_nxt, x_nxt }).is_icky()) {
                 continue;
             }
 
-            stk.emplace(nxt);
-            visited[nxt] = true;
+            distances[nxt] = distances[cur] + 1;
+            previous[nxt] = cur;
+            que.push(nxt);
         }
     }
+
+    return false;
 }
 
-// 現在のフロアが連結かどうかを返す。
-// 各セルの8近傍は互いに移動可能とし、is_wall が真を返すセルのみを壁とみなす。
-//
-// 連結成分数が 0 の場合、偽を返す。
-static bool floor_is_connected(const FloorType *const floor_ptr, const IsWallFunc is_wall)
+/*!
+ * @brief 現在のフロアが連結かどうかを返し、小さな孤立領域があればトンネルで接続する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param is_wall 壁とみなすセルの判定関数
+ * @return 連結であるか、連結にできたか否か。連結成分数が 0 の場合は偽を返す
+ */
+static bool connect_floor(PlayerType *player_ptr, const IsWallFunc is_wall)
 {
-    static std::array<bool, MAX_HGT * MAX_WID> visited;
-
-    const int h = floor_ptr->height;
-    const int w = floor_ptr->width;
-
-    std::fill(begin(visited), end(visited), false);
+    auto components = label_floor_components(*player_ptr->current_floor_ptr, is_wall);
+    const auto &sizes = components.sizes;
+    if (sizes.size() <= 1) {
+        return sizes.size() == 1;
+    }
 
-    int n_component = 0; // 連結成分数
+    const auto main_label = static_cast<int>(std::distance(sizes.begin(), std::max_element(sizes.begin(), sizes.end())));
+    std::string sizes_str;
+    for (const auto size : sizes) {
+        sizes_str.append(sizes_str.empty() ? "" : ",").append(std::to_string(size));
+    }
 
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            const int idx = w * y + x;
-            if (visited[idx]) {
-                continue;
-            }
-            if (is_wall(floor_ptr, y, x)) {
-                continue;
-            }
+    msg_print_wizard(player_ptr, CHEAT_DUNGEON, format(_("フロアが%d個の領域に分かれている(%s)。", "Floor has %d components (%s)."), static_cast<int>(sizes.size()), sizes_str.data()));
+    for (auto label = 0; label < std::ssize(sizes); ++label) {
+        if (label == main_label) {
+            continue;
+        }
 
-            if (++n_component >= 2) {
-                break;
-            }
-            floor_is_connected_dfs(floor_ptr, is_wall, y, x, visited.data());
+        if ((sizes[label] > MAX_POCKET_SIZE) || !tunnel_floor_pocket(player_ptr, components, label, main_label)) {
+            return false;
         }
     }
 
-    return n_component == 1;
+    return true;
 }
 
 /*!
- * ダンジョンのランダムフロアを生成する / Generates a random dungeon level -RAK-
- * @parama player_ptr プレイヤーへの参照ポインタ
- * @note Hack -- regenerate any "overflow" levels
+ * @brief フロア生成の試行に用いる乱数のシードを導出する
+ * @param floor_seed フロア毎にゲームの乱数から得たシード
+ * @param num 試行回数 (0から数える)
+ * @return 試行に用いる乱数のシード
  */
-void generate_floor(PlayerType *player_ptr)
+static uint32_t derive_floor_generation_seed(uint32_t floor_seed, int num)
+{
+    // 黄金比に基づく定数で試行毎にシードを散らす
+    return floor_seed + static_cast<uint32_t>(num) * 0x9E3779B9U;
+}
+
+/*!
+ * @brief フロアの生成を成功するまで試行する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param floor_seed フロア毎にゲームの乱数から得たシード
+ * @param num_begin 最初の試行回数 (0から数える)
+ * @param num_end 試行回数の上限 (この回数の試行は行わない)
+ * @return フロアの生成に成功したか否か
+ * @details
+ * 各試行はフロア生成用の乱数列から導いた独立な乱数列で行う.
+ * 失敗した試行が消費した乱数の量によらず、n回目の試行の結果はシードとnだけで決まる.
+ */
+bool generate_floor_attempts(PlayerType *player_ptr, uint32_t floor_seed, int num_begin, int num_end)
 {
     auto &floor = *player_ptr->current_floor_ptr;
-    set_floor_and_wall(floor.dungeon_idx);
     const auto is_wild_mode = AngbandWorld::get_instance().is_wild_mode();
-    for (int num = 0; true; num++) {
+    auto &statistics = FloorGenerationStatistics::get_instance();
+    for (auto num = num_begin; num < num_end; num++) {
+        const RngStreamGuard rng_guard(Xoshiro128StarStar(derive_floor_generation_seed(floor_seed, num)));
+        statistics.begin_attempt();
         bool okay = true;
         concptr why = nullptr;
         clear_cave(player_ptr);
@@ -530,13 +662,13 @@ void generate_floor(PlayerType *player_ptr)
         }
 
         // ダンジョン内フロアが連結でない(永久壁で区切られた孤立部屋がある)場合、
-        // 狂戦士でのプレイに支障をきたしうるので再生成する。
+        // 狂戦士でのプレイに支障をきたしうるので、小さな孤立部屋はトンネルで接続し、それ以外は再生成する。
         // 地上、荒野マップ、クエストでは連結性判定は行わない。
         // TODO: 本来はダンジョン生成アルゴリズム自身で連結性を保証するのが理想ではある。
         const bool check_conn = okay && floor.is_in_underground() && !floor.is_in_quest();
-        if (check_conn && !floor_is_connected(&floor, is_permanent_blocker)) {
+        if (check_conn && !connect_floor(player_ptr, is_permanent_blocker)) {
             // 一定回数試しても連結にならないなら諦める。
-            if (num >= 1000) {
+            if (num >= MAX_FLOOR_CONNECTION_ATTEMPTS) {
                 plog("cannot generate connected floor. giving up...");
             } else {
                 why = _("フロアが連結でない", "floor is not connected");
@@ -545,9 +677,10 @@ void generate_floor(PlayerType *player_ptr)
         }
 
         if (okay) {
-            break;
+            return true;
         }
 
+        statistics.add_retry(why ? why : _("不明", "unknown"));
         if (why) {
             msg_format(_("生成やり直し(%s)", "Generation restarted (%s)"), why);
         }
@@ -556,6 +689,30 @@ void generate_floor(PlayerType *player_ptr)
         wipe_monsters_list(player_ptr);
     }
 
+    return false;
+}
+
+/*!
+ * ダンジョンのランダムフロアを生成する / Generates a random dungeon level -RAK-
+ * @parama player_ptr プレイヤーへの参照ポインタ
+ * @note Hack -- regenerate any "overflow" levels
+ * @details
+ * 階段の先を子プロセスで先に生成してあればそれを使う.
+ * 無ければ試行を子プロセスで並行して行うか、順に行う. いずれの場合も採用する試行は同じになる.
+ */
+void generate_floor(PlayerType *player_ptr)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    set_floor_and_wall(floor.dungeon_idx);
+    const auto floor_seed = AngbandSystem::get_instance().get_rng_stream(RngStream::FLOOR_GENERATION)();
+    FloorGenerationStatistics::get_instance().begin_floor();
+    auto num = 0;
+    auto is_generated = commit_next_floor_generation(player_ptr, floor_seed);
+    is_generated = is_generated || generate_floor_in_parallel(player_ptr, floor_seed, &num);
+    if (!is_generated) {
+        (void)generate_floor_attempts(player_ptr, floor_seed, num);
+    }
+
     glow_deep_lava_and_bldg(player_ptr);
     player_ptr->enter_dungeon = false;
     wipe_generate_random_floor_flags(&floor);
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
+constexpr auto MAX_FLOOR_CONNECTION_ATTEMPTS = 1000; //!< 連結でないフロアを再生成する試行回数の上限
+
 class FloorType;
 class PlayerType;
 void wipe_generate_random_floor_flags(FloorType *floor_ptr);
 void clear_cave(PlayerType *player_ptr);
+bool generate_floor_attempts(PlayerType *player_ptr, uint32_t floor_seed, int num_begin, int num_end = std::numeric_limits<int>::max());
 void generate_floor(PlayerType *player_ptr);
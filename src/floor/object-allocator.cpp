@@ -18,6 +18,8 @@
 #include "system/terrain-type-definition.h"
 #include "util/bit-flags-calculator.h"
 #include "wizard/wizard-messages.h"
+#include <optional>
+#include <vector>
 
 /*!
  * @brief 上下左右の外壁数をカウントする / Count the number of walls adjacent to the given grid.
@@ -172,48 +174,83 @@ static void place_rubble(FloorType *floor_ptr, POSITION y, POSITION x)
     set_cave_feat(floor_ptr, y, x, feat_rubble);
 }
 
+/*!
+ * @brief alloc_object()の補助として指定の位置にオブジェクトを配置できるかの判定を行う
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param set 配置したい地形の種類
+ * @param pos 判定する座標
+ * @return 配置できるならばtrue
+ */
+static bool is_object_allocatable(PlayerType *player_ptr, dap_type set, const Pos2D &pos)
+{
+    const auto &grid = player_ptr->current_floor_ptr->get_grid(pos);
+    if (!grid.is_floor() || !grid.o_idx_list.empty() || grid.has_monster()) {
+        return false;
+    }
+
+    if (player_ptr->is_located_at(pos)) {
+        return false;
+    }
+
+    auto is_room = grid.is_room();
+    return !(((set == ALLOC_SET_CORR) && is_room) || ((set == ALLOC_SET_ROOM) && !is_room));
+}
+
 /*!
  * @brief フロア上のランダム位置に各種オブジェクトを配置する / Allocates some objects (using "place" and "type")
  * @param set 配置したい地形の種類
  * @param typ 配置したいオブジェクトの種類
  * @param num 配置したい数
  * @return 規定数通りに生成に成功したらTRUEを返す。
+ * @details
+ * 通常はマスを無作為に選べばすぐに見つかるため、まずはそれを試す.
+ * 見つからなければ配置できるマスを一度だけ列挙し、以降はその中から選ぶ.
+ * 混雑したフロアでも試行回数の上限に達して配置を諦めることはなくなる.
  */
 void alloc_object(PlayerType *player_ptr, dap_type set, dungeon_allocation_type typ, int num)
 {
-    POSITION y = 0;
-    POSITION x = 0;
-    int dummy = 0;
+    constexpr auto random_attempts = 100;
     auto *floor_ptr = player_ptr->current_floor_ptr;
     num = num * floor_ptr->height * floor_ptr->width / (MAX_HGT * MAX_WID) + 1;
+    std::optional<std::vector<Pos2D>> candidates;
     for (int k = 0; k < num; k++) {
-        while (dummy < SAFE_MAX_ATTEMPTS) {
-            dummy++;
-            y = randint0(floor_ptr->height);
-            x = randint0(floor_ptr->width);
-            const Pos2D pos(y, x);
-            const auto &grid = floor_ptr->get_grid(pos);
-            if (!grid.is_floor() || !grid.o_idx_list.empty() || grid.has_monster()) {
-                continue;
+        std::optional<Pos2D> pos_selected;
+        for (auto i = 0; !candidates && (i < random_attempts); i++) {
+            const Pos2D pos(randint0(floor_ptr->height), randint0(floor_ptr->width));
+            if (is_object_allocatable(player_ptr, set, pos)) {
+                pos_selected = pos;
+                break;
             }
+        }
 
-            if (player_ptr->is_located_at(pos)) {
-                continue;
+        if (!pos_selected && !candidates) {
+            candidates.emplace();
+            for (auto y = 0; y < floor_ptr->height; y++) {
+                for (auto x = 0; x < floor_ptr->width; x++) {
+                    const Pos2D pos(y, x);
+                    if (is_object_allocatable(player_ptr, set, pos)) {
+                        candidates->push_back(pos);
+                    }
+                }
             }
+        }
 
-            auto is_room = grid.is_room();
-            if (((set == ALLOC_SET_CORR) && is_room) || ((set == ALLOC_SET_ROOM) && !is_room)) {
-                continue;
+        while (!pos_selected && candidates && !candidates->empty()) {
+            const auto pick = randint0(static_cast<int>(candidates->size()));
+            const auto pos = (*candidates)[pick];
+            (*candidates)[pick] = candidates->back();
+            candidates->pop_back();
+            if (is_object_allocatable(player_ptr, set, pos)) {
+                pos_selected = pos;
             }
-
-            break;
         }
 
-        if (dummy >= SAFE_MAX_ATTEMPTS) {
+        if (!pos_selected) {
             msg_print_wizard(player_ptr, CHEAT_DUNGEON, _("アイテムの配置に失敗しました。", "Failed to place object."));
             return;
         }
 
+        const auto [y, x] = *pos_selected;
         switch (typ) {
         case ALLOC_TYP_RUBBLE:
             place_rubble(floor_ptr, y, x);
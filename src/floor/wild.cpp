@@ -36,18 +36,24 @@
 #include "player/player-status.h"
 #include "spell-realm/spells-hex.h"
 #include "status/action-setter.h"
-#include "system/angband-system.h"
 #include "system/dungeon-info.h"
 #include "system/floor-type-definition.h"
 #include "system/grid-type-definition.h"
 #include "system/monster-entity.h"
 #include "system/player-type-definition.h"
+#include "system/rng-stream-guard.h"
 #include "system/system-variables.h"
 #include "system/terrain-type-definition.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 #include "window/main-window-util.h"
 #include "world/world.h"
+#include <algorithm>
+#include <array>
+#include <list>
+#include <memory>
+#include <optional>
+#include <utility>
 
 constexpr auto MAX_FEAT_IN_TERRAIN = 18;
 
@@ -78,6 +84,11 @@ struct wilderness_grid {
 
 static border_type border;
 
+/*!
+ * @brief 荒野フロア1つ分の地形ID (生成途中は地形IDではなく高さを格納する)
+ */
+using WildernessTerrainMap = std::array<std::array<FEAT_IDX, MAX_WID>, MAX_HGT>;
+
 static wilderness_grid w_letter[255];
 
 /* The default table in terrain level generation. */
@@ -136,6 +147,7 @@ void set_floor_and_wall(DUNGEON_IDX type)
 /*!
  * @brief プラズマフラクタル的地形生成の再帰中間処理
  * / Helper for plasma generation.
+ * @param map 生成中の地形マップ
  * @param x1 左上端の深み
  * @param x2 右上端の深み
  * @param x3 左下端の深み
@@ -146,7 +158,7 @@ void set_floor_and_wall(DUNGEON_IDX type)
  * @param depth_max 深みの最大値
  */
 static void perturb_point_mid(
-    FloorType *floor_ptr, FEAT_IDX x1, FEAT_IDX x2, FEAT_IDX x3, FEAT_IDX x4, POSITION xmid, POSITION ymid, FEAT_IDX rough, FEAT_IDX depth_max)
+    WildernessTerrainMap &map, FEAT_IDX x1, FEAT_IDX x2, FEAT_IDX x3, FEAT_IDX x4, POSITION xmid, POSITION ymid, FEAT_IDX rough, FEAT_IDX depth_max)
 {
     FEAT_IDX tmp2 = rough * 2 + 1;
     FEAT_IDX tmp = randint1(tmp2) - (rough + 1);
@@ -163,12 +175,13 @@ static void perturb_point_mid(
         avg = depth_max;
     }
 
-    floor_ptr->grid_array[ymid][xmid].feat = (FEAT_IDX)avg;
+    map[ymid][xmid] = (FEAT_IDX)avg;
 }
 
 /*!
  * @brief プラズマフラクタル的地形生成の再帰末端処理
  * / Helper for plasma generation.
+ * @param map 生成中の地形マップ
  * @param x1 中間末端部1の重み
  * @param x2 中間末端部2の重み
  * @param x3 中間末端部3の重み
@@ -177,7 +190,7 @@ static void perturb_point_mid(
  * @param rough ランダム幅
  * @param depth_max 深みの最大値
  */
-static void perturb_point_end(FloorType *floor_ptr, FEAT_IDX x1, FEAT_IDX x2, FEAT_IDX x3, POSITION xmid, POSITION ymid, FEAT_IDX rough, FEAT_IDX depth_max)
+static void perturb_point_end(WildernessTerrainMap &map, FEAT_IDX x1, FEAT_IDX x2, FEAT_IDX x3, POSITION xmid, POSITION ymid, FEAT_IDX rough, FEAT_IDX depth_max)
 {
     FEAT_IDX tmp2 = rough * 2 + 1;
     FEAT_IDX tmp = randint0(tmp2) - rough;
@@ -194,12 +207,13 @@ static void perturb_point_end(FloorType *floor_ptr, FEAT_IDX x1, FEAT_IDX x2, FE
         avg = depth_max;
     }
 
-    floor_ptr->grid_array[ymid][xmid].feat = (FEAT_IDX)avg;
+    map[ymid][xmid] = (FEAT_IDX)avg;
 }
 
 /*!
  * @brief プラズマフラクタル的地形生成の開始処理
  * / Helper for plasma generation.
+ * @param map 生成中の地形マップ
  * @param x1 処理範囲の左上X座標
  * @param y1 処理範囲の左上Y座標
  * @param x2 処理範囲の右下X座標
@@ -209,13 +223,12 @@ static void perturb_point_end(FloorType *floor_ptr, FEAT_IDX x1, FEAT_IDX x2, FE
  * @details
  * <pre>
  * A generic function to generate the plasma fractal.
- * Note that it uses ``cave_feat'' as temporary storage.
- * The values in ``cave_feat'' after this function
+ * The values in the map after this function
  * are NOT actual features; They are raw heights which
  * need to be converted to features.
  * </pre>
  */
-static void plasma_recursive(FloorType *floor_ptr, POSITION x1, POSITION y1, POSITION x2, POSITION y2, FEAT_IDX depth_max, FEAT_IDX rough)
+static void plasma_recursive(WildernessTerrainMap &map, POSITION x1, POSITION y1, POSITION x2, POSITION y2, FEAT_IDX depth_max, FEAT_IDX rough)
 {
     POSITION xmid = (x2 - x1) / 2 + x1;
     POSITION ymid = (y2 - y1) / 2 + y1;
@@ -223,86 +236,221 @@ static void plasma_recursive(FloorType *floor_ptr, POSITION x1, POSITION y1, POS
         return;
     }
 
-    perturb_point_mid(floor_ptr, floor_ptr->grid_array[y1][x1].feat, floor_ptr->grid_array[y2][x1].feat, floor_ptr->grid_array[y1][x2].feat,
-        floor_ptr->grid_array[y2][x2].feat, xmid, ymid, rough, depth_max);
-    perturb_point_end(
-        floor_ptr, floor_ptr->grid_array[y1][x1].feat, floor_ptr->grid_array[y1][x2].feat, floor_ptr->grid_array[ymid][xmid].feat, xmid, y1, rough, depth_max);
-    perturb_point_end(
-        floor_ptr, floor_ptr->grid_array[y1][x2].feat, floor_ptr->grid_array[y2][x2].feat, floor_ptr->grid_array[ymid][xmid].feat, x2, ymid, rough, depth_max);
-    perturb_point_end(
-        floor_ptr, floor_ptr->grid_array[y2][x2].feat, floor_ptr->grid_array[y2][x1].feat, floor_ptr->grid_array[ymid][xmid].feat, xmid, y2, rough, depth_max);
-    perturb_point_end(
-        floor_ptr, floor_ptr->grid_array[y2][x1].feat, floor_ptr->grid_array[y1][x1].feat, floor_ptr->grid_array[ymid][xmid].feat, x1, ymid, rough, depth_max);
-    plasma_recursive(floor_ptr, x1, y1, xmid, ymid, depth_max, rough);
-    plasma_recursive(floor_ptr, xmid, y1, x2, ymid, depth_max, rough);
-    plasma_recursive(floor_ptr, x1, ymid, xmid, y2, depth_max, rough);
-    plasma_recursive(floor_ptr, xmid, ymid, x2, y2, depth_max, rough);
+    perturb_point_mid(map, map[y1][x1], map[y2][x1], map[y1][x2], map[y2][x2], xmid, ymid, rough, depth_max);
+    perturb_point_end(map, map[y1][x1], map[y1][x2], map[ymid][xmid], xmid, y1, rough, depth_max);
+    perturb_point_end(map, map[y1][x2], map[y2][x2], map[ymid][xmid], x2, ymid, rough, depth_max);
+    perturb_point_end(map, map[y2][x2], map[y2][x1], map[ymid][xmid], xmid, y2, rough, depth_max);
+    perturb_point_end(map, map[y2][x1], map[y1][x1], map[ymid][xmid], x1, ymid, rough, depth_max);
+    plasma_recursive(map, x1, y1, xmid, ymid, depth_max, rough);
+    plasma_recursive(map, xmid, y1, x2, ymid, depth_max, rough);
+    plasma_recursive(map, x1, ymid, xmid, y2, depth_max, rough);
+    plasma_recursive(map, xmid, ymid, x2, y2, depth_max, rough);
 }
 
 /*!
- * @brief 荒野フロア生成のサブルーチン
- * @param terrain 荒野地形ID
- * @param seed 乱数の固定シード
- * @param border 未使用
- * @param corner 広域マップの角部分としての生成ならばTRUE
+ * @brief 荒野フロアの四隅のうち1つの地形を生成する
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ * @param gy 四隅のフロア内Y座標 (1 または MAX_HGT - 2)
+ * @param gx 四隅のフロア内X座標 (1 または MAX_WID - 2)
+ * @return 地形ID
+ * @details 四隅は左上・左下・右上・右下の順に乱数の最初の4つで決まるため、フロア全体を生成した時の四隅と一致する.
  */
-static void generate_wilderness_area(FloorType *floor_ptr, int terrain, uint32_t seed, bool corner)
+static FEAT_IDX generate_wilderness_corner(POSITION y, POSITION x, POSITION gy, POSITION gx)
 {
+    const auto terrain = wilderness[y][x].terrain;
     if (terrain == TERRAIN_EDGE) {
-        for (POSITION y1 = 0; y1 < MAX_HGT; y1++) {
-            for (POSITION x1 = 0; x1 < MAX_WID; x1++) {
-                floor_ptr->grid_array[y1][x1].feat = feat_permanent;
-            }
-        }
+        return feat_permanent;
+    }
+
+    const RngStreamGuard rng_guard(Xoshiro128StarStar(wilderness[y][x].seed));
+    const auto index = ((gy == 1) ? 0 : 1) + ((gx == 1) ? 0 : 2);
+    int16_t height = 0;
+    for (auto i = 0; i <= index; i++) {
+        height = (int16_t)randint0(MAX_FEAT_IN_TERRAIN);
+    }
 
+    return terrain_table[terrain][height];
+}
+
+/*!
+ * @brief 荒野フロアに道を敷く
+ * @param map 生成中の地形マップ
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ */
+static void place_wilderness_road(WildernessTerrainMap &map, POSITION y, POSITION x)
+{
+    //!< @todo make the road a bit more interresting.
+    if (!wilderness[y][x].road) {
         return;
     }
 
-    auto &system = AngbandSystem::get_instance();
-    const Xoshiro128StarStar rng_backup = system.get_rng();
-    Xoshiro128StarStar wilderness_rng(seed);
-    system.set_rng(wilderness_rng);
-    int table_size = sizeof(terrain_table[0]) / sizeof(int16_t);
-    if (!corner) {
-        for (POSITION y1 = 0; y1 < MAX_HGT; y1++) {
-            for (POSITION x1 = 0; x1 < MAX_WID; x1++) {
-                floor_ptr->grid_array[y1][x1].feat = table_size / 2;
-            }
+    map[MAX_HGT / 2][MAX_WID / 2] = feat_floor;
+    if (wilderness[y - 1][x].road) {
+        /* North road */
+        for (POSITION y1 = 1; y1 < MAX_HGT / 2; y1++) {
+            map[y1][MAX_WID / 2] = feat_floor;
+        }
+    }
+
+    if (wilderness[y + 1][x].road) {
+        /* South road */
+        for (POSITION y1 = MAX_HGT / 2; y1 < MAX_HGT - 1; y1++) {
+            map[y1][MAX_WID / 2] = feat_floor;
+        }
+    }
+
+    if (wilderness[y][x + 1].road) {
+        /* East road */
+        for (POSITION x1 = MAX_WID / 2; x1 < MAX_WID - 1; x1++) {
+            map[MAX_HGT / 2][x1] = feat_floor;
         }
     }
 
-    floor_ptr->grid_array[1][1].feat = (int16_t)randint0(table_size);
-    floor_ptr->grid_array[MAX_HGT - 2][1].feat = (int16_t)randint0(table_size);
-    floor_ptr->grid_array[1][MAX_WID - 2].feat = (int16_t)randint0(table_size);
-    floor_ptr->grid_array[MAX_HGT - 2][MAX_WID - 2].feat = (int16_t)randint0(table_size);
-    if (corner) {
-        floor_ptr->grid_array[1][1].feat = terrain_table[terrain][floor_ptr->grid_array[1][1].feat];
-        floor_ptr->grid_array[MAX_HGT - 2][1].feat = terrain_table[terrain][floor_ptr->grid_array[MAX_HGT - 2][1].feat];
-        floor_ptr->grid_array[1][MAX_WID - 2].feat = terrain_table[terrain][floor_ptr->grid_array[1][MAX_WID - 2].feat];
-        floor_ptr->grid_array[MAX_HGT - 2][MAX_WID - 2].feat = terrain_table[terrain][floor_ptr->grid_array[MAX_HGT - 2][MAX_WID - 2].feat];
-        system.set_rng(rng_backup);
+    if (wilderness[y][x - 1].road) {
+        /* West road */
+        for (POSITION x1 = 1; x1 < MAX_WID / 2; x1++) {
+            map[MAX_HGT / 2][x1] = feat_floor;
+        }
+    }
+}
+
+/*!
+ * @brief 荒野フロア生成のサブルーチン
+ * @param map 地形を書き込むマップ
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ */
+static void generate_wilderness_area(WildernessTerrainMap &map, POSITION y, POSITION x)
+{
+    const auto terrain = wilderness[y][x].terrain;
+    if (terrain == TERRAIN_EDGE) {
+        for (auto &row : map) {
+            row.fill(feat_permanent);
+        }
+
         return;
     }
 
-    const auto top_left = floor_ptr->grid_array[1][1].feat;
-    const auto bottom_left = floor_ptr->grid_array[MAX_HGT - 2][1].feat;
-    const auto top_right = floor_ptr->grid_array[1][MAX_WID - 2].feat;
-    const auto bottom_right = floor_ptr->grid_array[MAX_HGT - 2][MAX_WID - 2].feat;
+    const RngStreamGuard rng_guard(Xoshiro128StarStar(wilderness[y][x].seed));
+    constexpr auto table_size = MAX_FEAT_IN_TERRAIN;
+    for (auto &row : map) {
+        row.fill(table_size / 2);
+    }
+
+    const auto top_left = (int16_t)randint0(table_size);
+    const auto bottom_left = (int16_t)randint0(table_size);
+    const auto top_right = (int16_t)randint0(table_size);
+    const auto bottom_right = (int16_t)randint0(table_size);
+    map[1][1] = top_left;
+    map[MAX_HGT - 2][1] = bottom_left;
+    map[1][MAX_WID - 2] = top_right;
+    map[MAX_HGT - 2][MAX_WID - 2] = bottom_right;
     const short roughness = 1; /* The roughness of the level. */
-    plasma_recursive(floor_ptr, 1, 1, MAX_WID - 2, MAX_HGT - 2, table_size - 1, roughness);
-    floor_ptr->grid_array[1][1].feat = top_left;
-    floor_ptr->grid_array[MAX_HGT - 2][1].feat = bottom_left;
-    floor_ptr->grid_array[1][MAX_WID - 2].feat = top_right;
-    floor_ptr->grid_array[MAX_HGT - 2][MAX_WID - 2].feat = bottom_right;
+    plasma_recursive(map, 1, 1, MAX_WID - 2, MAX_HGT - 2, table_size - 1, roughness);
+    map[1][1] = top_left;
+    map[MAX_HGT - 2][1] = bottom_left;
+    map[1][MAX_WID - 2] = top_right;
+    map[MAX_HGT - 2][MAX_WID - 2] = bottom_right;
     for (POSITION y1 = 1; y1 < MAX_HGT - 1; y1++) {
         for (POSITION x1 = 1; x1 < MAX_WID - 1; x1++) {
-            floor_ptr->grid_array[y1][x1].feat = terrain_table[terrain][floor_ptr->grid_array[y1][x1].feat];
+            map[y1][x1] = terrain_table[terrain][map[y1][x1]];
         }
     }
 
-    system.set_rng(rng_backup);
+    place_wilderness_road(map, y, x);
+}
+
+/*!
+ * @brief 生成した荒野フロアの地形を保持するLRUキャッシュ
+ * @details
+ * 荒野フロアは広域座標毎の乱数シードから決定的に生成されるため、移動の度に自身と周囲8フロアを
+ * 生成し直す代わりに、最近生成したものを使い回す. 町は定義ファイルから生成するため対象外.
+ * 荒野定義を読み直した場合は地勢や道が変わり得るため破棄する.
+ */
+class WildernessAreaCache {
+public:
+    const WildernessTerrainMap &get(POSITION y, POSITION x);
+    void clear();
+
+private:
+    static constexpr size_t CAPACITY = 16; //!< 保持するフロア数 (現在地と周囲8フロアに加え、1歩移動した先の分)
+
+    /*!
+     * @brief キャッシュの1エントリ
+     */
+    struct Entry {
+        POSITION y; //!< 広域Y座標
+        POSITION x; //!< 広域X座標
+        uint32_t seed; //!< 生成に用いた乱数シード
+        wt_type terrain; //!< 生成に用いた荒野地形ID
+        std::unique_ptr<WildernessTerrainMap> map; //!< 生成した地形
+    };
+
+    std::list<Entry> entries; //!< 最近使用した順のエントリ
+
+    const WildernessTerrainMap *find(POSITION y, POSITION x);
+};
+
+/*!
+ * @brief 荒野フロアの地形を得る。キャッシュになければ生成する
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ * @return 地形マップ (次にキャッシュを操作するまで有効)
+ */
+const WildernessTerrainMap &WildernessAreaCache::get(POSITION y, POSITION x)
+{
+    if (const auto *map = this->find(y, x)) {
+        return *map;
+    }
+
+    std::unique_ptr<WildernessTerrainMap> map;
+    if (this->entries.size() >= CAPACITY) {
+        map = std::move(this->entries.back().map);
+        this->entries.pop_back();
+    } else {
+        map = std::make_unique<WildernessTerrainMap>();
+    }
+
+    generate_wilderness_area(*map, y, x);
+    const auto &area = wilderness[y][x];
+    this->entries.push_front({ y, x, area.seed, area.terrain, std::move(map) });
+    return *this->entries.front().map;
+}
+
+/*!
+ * @brief キャッシュ済みの荒野フロアの地形を探す
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ * @return 地形マップ。キャッシュになければnullptr
+ */
+const WildernessTerrainMap *WildernessAreaCache::find(POSITION y, POSITION x)
+{
+    const auto &area = wilderness[y][x];
+    const auto it = std::find_if(this->entries.begin(), this->entries.end(), [&](const Entry &entry) {
+        return (entry.y == y) && (entry.x == x) && (entry.seed == area.seed) && (entry.terrain == area.terrain);
+    });
+    if (it == this->entries.end()) {
+        return nullptr;
+    }
+
+    this->entries.splice(this->entries.begin(), this->entries, it);
+    return this->entries.front().map.get();
 }
 
+void WildernessAreaCache::clear()
+{
+    this->entries.clear();
+}
+
+static WildernessAreaCache wilderness_area_cache;
+
+/*!
+ * @brief 荒野定義を最後に読み込んだ時の町の設定 (vanilla_town, lite_town)
+ */
+static std::optional<std::pair<bool, bool>> parsed_wilderness_mode;
+
 /*!
  * @brief 荒野フロア生成のメインルーチン
  * @param player_ptr プレイヤーへの参照ポインタ
@@ -332,46 +480,10 @@ static void generate_area(PlayerType *player_ptr, POSITION y, POSITION x, bool i
             player_ptr->visit |= (1UL << (player_ptr->town_num - 1));
         }
     } else {
-        int terrain = wilderness[y][x].terrain;
-        uint32_t seed = wilderness[y][x].seed;
-        generate_wilderness_area(floor_ptr, terrain, seed, is_corner);
-    }
-
-    if (!is_corner && !wilderness[y][x].town) {
-        //!< @todo make the road a bit more interresting.
-        if (wilderness[y][x].road) {
-            floor_ptr->grid_array[MAX_HGT / 2][MAX_WID / 2].feat = feat_floor;
-            POSITION x1, y1;
-            if (wilderness[y - 1][x].road) {
-                /* North road */
-                for (y1 = 1; y1 < MAX_HGT / 2; y1++) {
-                    x1 = MAX_WID / 2;
-                    floor_ptr->grid_array[y1][x1].feat = feat_floor;
-                }
-            }
-
-            if (wilderness[y + 1][x].road) {
-                /* North road */
-                for (y1 = MAX_HGT / 2; y1 < MAX_HGT - 1; y1++) {
-                    x1 = MAX_WID / 2;
-                    floor_ptr->grid_array[y1][x1].feat = feat_floor;
-                }
-            }
-
-            if (wilderness[y][x + 1].road) {
-                /* East road */
-                for (x1 = MAX_WID / 2; x1 < MAX_WID - 1; x1++) {
-                    y1 = MAX_HGT / 2;
-                    floor_ptr->grid_array[y1][x1].feat = feat_floor;
-                }
-            }
-
-            if (wilderness[y][x - 1].road) {
-                /* West road */
-                for (x1 = 1; x1 < MAX_WID / 2; x1++) {
-                    y1 = MAX_HGT / 2;
-                    floor_ptr->grid_array[y1][x1].feat = feat_floor;
-                }
+        const auto &map = wilderness_area_cache.get(y, x);
+        for (POSITION y1 = 0; y1 < MAX_HGT; y1++) {
+            for (POSITION x1 = 0; x1 < MAX_WID; x1++) {
+                floor_ptr->grid_array[y1][x1].feat = map[y1][x1];
             }
         }
     }
@@ -384,15 +496,56 @@ static void generate_area(PlayerType *player_ptr, POSITION y, POSITION x, bool i
         return;
     }
 
-    auto &system = AngbandSystem::get_instance();
-    const Xoshiro128StarStar rng_backup = system.get_rng();
-    Xoshiro128StarStar wilderness_rng(wilderness[y][x].seed);
-    system.set_rng(wilderness_rng);
+    const RngStreamGuard rng_guard(Xoshiro128StarStar(wilderness[y][x].seed));
     int dy = rand_range(6, floor_ptr->height - 6);
     int dx = rand_range(6, floor_ptr->width - 6);
     floor_ptr->grid_array[dy][dx].feat = feat_entrance;
     floor_ptr->grid_array[dy][dx].special = wilderness[y][x].entrance;
-    system.set_rng(rng_backup);
+}
+
+/*!
+ * @brief 隣接する荒野フロアの地形を得る
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ * @param town_map 町だった場合に地形を書き写すマップ
+ * @return 地形マップ
+ * @details 町以外はキャッシュから得るため、フロアへの書き込みは行わない.
+ */
+static const WildernessTerrainMap &get_neighbor_area(PlayerType *player_ptr, POSITION y, POSITION x, WildernessTerrainMap &town_map)
+{
+    if (!wilderness[y][x].town) {
+        return wilderness_area_cache.get(y, x);
+    }
+
+    generate_area(player_ptr, y, x, true, false);
+    const auto &floor = *player_ptr->current_floor_ptr;
+    for (POSITION y1 = 0; y1 < MAX_HGT; y1++) {
+        for (POSITION x1 = 0; x1 < MAX_WID; x1++) {
+            town_map[y1][x1] = floor.grid_array[y1][x1].feat;
+        }
+    }
+
+    return town_map;
+}
+
+/*!
+ * @brief 斜めに隣接する荒野フロアの角の地形を得る
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param y 広域Y座標
+ * @param x 広域X座標
+ * @param gy 角のフロア内Y座標
+ * @param gx 角のフロア内X座標
+ * @return 地形ID
+ */
+static FEAT_IDX get_neighbor_corner(PlayerType *player_ptr, POSITION y, POSITION x, POSITION gy, POSITION gx)
+{
+    if (!wilderness[y][x].town) {
+        return generate_wilderness_corner(y, x, gy, gx);
+    }
+
+    generate_area(player_ptr, y, x, false, true);
+    return player_ptr->current_floor_ptr->grid_array[gy][gx].feat;
 }
 
 /*!
@@ -431,50 +584,40 @@ void wilderness_gen(PlayerType *player_ptr)
     panel_row_min = floor.height;
     panel_col_min = floor.width;
     auto &world = AngbandWorld::get_instance();
-    parse_fixed_map(player_ptr, WILDERNESS_DEFINITION, 0, 0, world.max_wild_y, world.max_wild_x);
+    parse_wilderness_definition(player_ptr);
     const auto wild_y = player_ptr->wilderness_y;
     const auto wild_x = player_ptr->wilderness_x;
     get_mon_num_prep(player_ptr, get_monster_hook(player_ptr), nullptr);
 
     /* North border */
-    generate_area(player_ptr, wild_y - 1, wild_x, true, false);
+    WildernessTerrainMap town_map;
+    const auto &north = get_neighbor_area(player_ptr, wild_y - 1, wild_x, town_map);
     for (int i = 1; i < MAX_WID - 1; i++) {
-        border.top[i] = floor.grid_array[MAX_HGT - 2][i].feat;
+        border.top[i] = north[MAX_HGT - 2][i];
     }
 
     /* South border */
-    generate_area(player_ptr, wild_y + 1, wild_x, true, false);
+    const auto &south = get_neighbor_area(player_ptr, wild_y + 1, wild_x, town_map);
     for (int i = 1; i < MAX_WID - 1; i++) {
-        border.bottom[i] = floor.grid_array[1][i].feat;
+        border.bottom[i] = south[1][i];
     }
 
     /* West border */
-    generate_area(player_ptr, wild_y, wild_x - 1, true, false);
+    const auto &west = get_neighbor_area(player_ptr, wild_y, wild_x - 1, town_map);
     for (int i = 1; i < MAX_HGT - 1; i++) {
-        border.left[i] = floor.grid_array[i][MAX_WID - 2].feat;
+        border.left[i] = west[i][MAX_WID - 2];
     }
 
     /* East border */
-    generate_area(player_ptr, wild_y, wild_x + 1, true, false);
+    const auto &east = get_neighbor_area(player_ptr, wild_y, wild_x + 1, town_map);
     for (int i = 1; i < MAX_HGT - 1; i++) {
-        border.right[i] = floor.grid_array[i][1].feat;
+        border.right[i] = east[i][1];
     }
 
-    /* North west corner */
-    generate_area(player_ptr, wild_y - 1, wild_x - 1, false, true);
-    border.top_left = floor.grid_array[MAX_HGT - 2][MAX_WID - 2].feat;
-
-    /* North east corner */
-    generate_area(player_ptr, wild_y - 1, wild_x + 1, false, true);
-    border.top_right = floor.grid_array[MAX_HGT - 2][1].feat;
-
-    /* South west corner */
-    generate_area(player_ptr, wild_y + 1, wild_x - 1, false, true);
-    border.bottom_left = floor.grid_array[1][MAX_WID - 2].feat;
-
-    /* South east corner */
-    generate_area(player_ptr, wild_y + 1, wild_x + 1, false, true);
-    border.bottom_right = floor.grid_array[1][1].feat;
+    border.top_left = get_neighbor_corner(player_ptr, wild_y - 1, wild_x - 1, MAX_HGT - 2, MAX_WID - 2);
+    border.top_right = get_neighbor_corner(player_ptr, wild_y - 1, wild_x + 1, MAX_HGT - 2, 1);
+    border.bottom_left = get_neighbor_corner(player_ptr, wild_y + 1, wild_x - 1, 1, MAX_WID - 2);
+    border.bottom_right = get_neighbor_corner(player_ptr, wild_y + 1, wild_x + 1, 1, 1);
 
     /* Create terrain of the current area */
     generate_area(player_ptr, wild_y, wild_x, false, false);
@@ -618,8 +761,8 @@ void wilderness_gen_small(PlayerType *player_ptr)
         }
     }
 
+    parse_wilderness_definition(player_ptr);
     const auto &world = AngbandWorld::get_instance();
-    parse_fixed_map(player_ptr, WILDERNESS_DEFINITION, 0, 0, world.max_wild_y, world.max_wild_x);
     for (int i = 0; i < world.max_wild_x; i++) {
         for (int j = 0; j < world.max_wild_y; j++) {
             if (wilderness[j][i].town && (wilderness[j][i].town != VALID_TOWNS)) {
@@ -801,6 +944,26 @@ parse_error_type parse_line_wilderness(PlayerType *player_ptr, char *buf, int xm
     return PARSE_ERROR_NONE;
 }
 
+/*!
+ * @brief 荒野定義を読み込む
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details
+ * 荒野定義の内容は町の設定に関するバースオプションにのみ依存するため、前回と同じ設定で読み込み済みであれば読み直さない.
+ * 読み直した場合は地勢や道が変わり得るため、生成済みの荒野フロアを破棄する.
+ */
+void parse_wilderness_definition(PlayerType *player_ptr)
+{
+    const auto mode = std::make_pair(vanilla_town, lite_town);
+    if (parsed_wilderness_mode == mode) {
+        return;
+    }
+
+    const auto &world = AngbandWorld::get_instance();
+    parse_fixed_map(player_ptr, WILDERNESS_DEFINITION, 0, 0, world.max_wild_y, world.max_wild_x);
+    parsed_wilderness_mode = mode;
+    wilderness_area_cache.clear();
+}
+
 /*!
  * @brief ゲーム開始時に各荒野フロアの乱数シードを指定する /
  * Generate the random seeds for the wilderness
@@ -814,6 +977,8 @@ void seed_wilderness(void)
             wilderness[y][x].entrance = 0;
         }
     }
+
+    parsed_wilderness_mode.reset();
 }
 
 /*!
@@ -44,5 +44,6 @@ void wilderness_gen_small(PlayerType *player_ptr);
 void init_wilderness_terrains();
 void init_wilderness_encounter();
 void seed_wilderness();
+void parse_wilderness_definition(PlayerType *player_ptr);
 parse_error_type parse_line_wilderness(PlayerType *player_ptr, char *buf, int xmin, int xmax, int *y, int *x);
 bool change_wild_mode(PlayerType *player_ptr, bool encount);
@@ -7,6 +7,9 @@ bool small_levels; /* Allow unusually small dungeon levels */
 bool always_small_levels; /* Always create unusually small dungeon levels */
 bool empty_levels; /* Allow empty 'on_defeat_arena_monster' levels */
 bool bound_walls_perm; /* Boundary walls become 'permanent wall' */
+bool compress_savedata; /* Compress whole savefiles */
+bool parallel_floor_generation; /* Generate floor attempts in parallel processes */
+bool pregenerate_next_floor; /* Generate the next floor while standing on stairs */
 bool last_words; /* Leave last words when your character dies */
 bool auto_dump; /* Dump a character record automatically */
 bool auto_debug_save; /* Dump a debug savedata every key input */
@@ -9,6 +9,9 @@ extern bool small_levels; /* Allow unusually small dungeon levels */
 extern bool always_small_levels; /* Always create unusually small dungeon levels */
 extern bool empty_levels; /* Allow empty 'on_defeat_arena_monster' levels */
 extern bool bound_walls_perm; /* Boundary walls become 'permanent wall' */
+extern bool compress_savedata; /* Compress whole savefiles */
+extern bool parallel_floor_generation; /* Generate floor attempts in parallel processes */
+extern bool pregenerate_next_floor; /* Generate the next floor while standing on stairs */
 extern bool last_words; /* Leave last words when your character dies */
 extern bool auto_dump; /* Dump a character record automatically */
 extern bool send_score; /* Send score dump to the world score server */
@@ -152,6 +152,18 @@ const std::vector<option_type> option_info = {
 
     { &bound_walls_perm, true, OPT_PAGE_GAMEPLAY, 2, 1, "bound_walls_perm", _("ダンジョンの外壁を永久岩にする", "Boundary walls become 'permanent wall'") },
 
+    { &compress_savedata, false, OPT_PAGE_GAMEPLAY, 2, 19, "compress_savedata", _("セーブファイル全体を圧縮して保存する", "Compress whole savefiles when saving") },
+
+#ifndef WINDOWS
+    { &parallel_floor_generation, false, OPT_PAGE_GAMEPLAY, 2, 20, "parallel_floor_generation", _("フロア生成の試行を複数のプロセスで並行して行う", "Generate floor attempts in parallel processes") },
+
+    { &pregenerate_next_floor, false, OPT_PAGE_GAMEPLAY, 2, 21, "pregenerate_next_floor", _("階段の上にいる間に次のフロアを生成しておく", "Generate the next floor while standing on stairs") },
+#else
+    { &parallel_floor_generation, false, OPT_PAGE_HIDE, 2, 20, "parallel_floor_generation", _("フロア生成の試行を複数のプロセスで並行して行う", "Generate floor attempts in parallel processes") },
+
+    { &pregenerate_next_floor, false, OPT_PAGE_HIDE, 2, 21, "pregenerate_next_floor", _("階段の上にいる間に次のフロアを生成しておく", "Generate the next floor while standing on stairs") },
+#endif
+
     { &last_words, true, OPT_PAGE_GAMEPLAY, 0, 28, "last_words", _("キャラクターが死んだ時遺言をのこす", "Leave last words when your character dies") },
 
     { &auto_dump, false, OPT_PAGE_GAMEPLAY, 4, 5, "auto_dump", _("自動的にキャラクターの記録をファイルに書き出す", "Dump a character record automatically") },
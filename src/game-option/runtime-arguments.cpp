@@ -9,3 +9,4 @@ bool arg_monochrome; /* Command arg -- Request monochrome mode */
 bool arg_force_original; /* Command arg -- Request original keyset */
 bool arg_force_roguelike; /* Command arg -- Request roguelike keyset */
 bool arg_bigtile = false; /* Command arg -- Request big tile mode */
+int arg_frame_rate = 0; /* Command arg -- Maximum screen updates per second (0 = unlimited) */
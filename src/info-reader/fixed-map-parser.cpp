@@ -25,11 +25,76 @@
 #include "util/string-processor.h"
 #include "view/display-messages.h"
 #include <algorithm>
+#include <functional>
+#include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 static concptr variant = "ZANGBAND";
 
+namespace {
+/*!
+ * @brief 固定マップ定義ファイルの1行
+ */
+struct FixedMapLine {
+    int number; //!< ファイル内の行番号 (0始まり)
+    bool is_condition; //!< 条件分岐 (?:) の行か否か
+    std::string text; //!< 行の内容 (条件分岐の行は条件式のみ)
+};
+
+/*!
+ * @brief 読み込み済みの固定マップ定義ファイル
+ * @details
+ * 固定マップはクエスト情報の更新のためだけに表示処理等からも頻繁に読まれるため、
+ * ファイル毎に空行とコメントを除いた行を一度だけ読み込んで保持する.
+ * 条件式はプレイヤーの状態に依存するため、保持した式を読む度に評価する.
+ */
+std::map<std::string, std::vector<FixedMapLine>, std::less<>> compiled_fixed_maps;
+
+/*!
+ * @brief 固定マップ定義ファイルを読み込み済みの形式で得る
+ * @param name ファイル名
+ * @return 行の配列。ファイルを開けなかった場合はnullptr
+ */
+const std::vector<FixedMapLine> *compile_fixed_map(std::string_view name)
+{
+    if (const auto it = compiled_fixed_maps.find(name); it != compiled_fixed_maps.end()) {
+        return &it->second;
+    }
+
+    const auto path = path_build(ANGBAND_DIR_EDIT, name);
+    auto *fp = angband_fopen(path, FileOpenMode::READ);
+    if (fp == nullptr) {
+        return nullptr;
+    }
+
+    std::vector<FixedMapLine> lines;
+    auto num = -1;
+    while (true) {
+        auto line_str = angband_fgets(fp);
+        if (!line_str) {
+            break;
+        }
+
+        num++;
+        if (line_str->empty() || iswspace(line_str->front()) || line_str->starts_with(('#'))) {
+            continue;
+        }
+
+        if (line_str->starts_with("?:")) {
+            lines.push_back({ num, true, line_str->substr(2) });
+            continue;
+        }
+
+        lines.push_back({ num, false, std::move(*line_str) });
+    }
+
+    angband_fclose(fp);
+    return &compiled_fixed_maps.emplace(name, std::move(lines)).first->second;
+}
+}
+
 /*!
  * @brief 固定マップ (クエスト＆街＆広域マップ)生成時の分岐処理
  * Helper function for "parse_fixed_map()"
@@ -242,32 +307,23 @@ static std::string parse_fixed_map_expression(PlayerType *player_ptr, char **sp,
  */
 parse_error_type parse_fixed_map(PlayerType *player_ptr, std::string_view name, int ymin, int xmin, int ymax, int xmax)
 {
-    const auto path = path_build(ANGBAND_DIR_EDIT, name);
-    auto *fp = angband_fopen(path, FileOpenMode::READ);
-    if (fp == nullptr) {
+    const auto *lines = compile_fixed_map(name);
+    if (lines == nullptr) {
         return PARSE_ERROR_GENERIC;
     }
 
-    int num = -1;
     parse_error_type err = PARSE_ERROR_NONE;
     bool bypass = false;
     int x = xmin;
     int y = ymin;
     qtwg_type tmp_qg;
     qtwg_type *qg_ptr = initialize_quest_generator_type(&tmp_qg, ymin, xmin, ymax, xmax, &y, &x);
-    while (true) {
-        auto line_str = angband_fgets(fp);
-        if (!line_str) {
-            break;
-        }
-        num++;
-        if (line_str->empty() || iswspace(line_str->front()) || line_str->starts_with(('#'))) {
-            continue;
-        }
-
-        if (line_str->starts_with("?:")) {
+    for (const auto &line : *lines) {
+        /* 解析処理はバッファを書き換えるため複製する */
+        auto buf = line.text;
+        if (line.is_condition) {
             char f;
-            auto *s = line_str->data() + 2;
+            auto *s = buf.data();
             auto v = parse_fixed_map_expression(player_ptr, &s, &f);
             bypass = v == "0";
             continue;
@@ -277,18 +333,17 @@ parse_error_type parse_fixed_map(PlayerType *player_ptr, std::string_view name,
             continue;
         }
 
-        qg_ptr->buf = line_str->data();
+        qg_ptr->buf = buf.data();
         err = generate_fixed_map_floor(player_ptr, qg_ptr, parse_fixed_map);
         if (err != PARSE_ERROR_NONE) {
             concptr oops = (((err > 0) && (err < PARSE_ERROR_MAX)) ? err_str[err] : "unknown");
-            msg_format("Error %d (%s) at line %d of '%s'.", err, oops, num, name.data());
-            msg_format(_("'%s'を解析中。", "Parsing '%s'."), line_str->data());
+            msg_format("Error %d (%s) at line %d of '%s'.", err, oops, line.number, name.data());
+            msg_format(_("'%s'を解析中。", "Parsing '%s'."), buf.data());
             msg_print(nullptr);
             break;
         }
     }
 
-    angband_fclose(fp);
     return err;
 }
 
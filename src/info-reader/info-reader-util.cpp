@@ -8,7 +8,7 @@
 #include "view/display-messages.h"
 
 /* Help give useful error messages */
-int error_idx; /*!< データ読み込み/初期化時に汎用的にエラーコードを保存するグローバル変数 */
+thread_local int error_idx; /*!< データ読み込み/初期化時に汎用的にエラーコードを保存する変数 (並列に読み込むためスレッド毎に持つ) */
 int error_line; /*!< データ読み込み/初期化時に汎用的にエラー行数を保存するグローバル変数 */
 
 /*!
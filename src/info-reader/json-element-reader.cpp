@@ -0,0 +1,169 @@
+#include "info-reader/json-element-reader.h"
+
+/*!
+ * @brief コンストラクタ
+ * @param keyname 要素を取り出す配列のキー
+ * @param handler 要素毎に呼び出す処理
+ */
+JSONArrayElementReader::JSONArrayElementReader(std::string_view keyname, ElementHandler handler)
+    : keyname(keyname)
+    , handler(std::move(handler))
+{
+}
+
+bool JSONArrayElementReader::null()
+{
+    return this->put(nullptr);
+}
+
+bool JSONArrayElementReader::boolean(bool val)
+{
+    return this->put(val);
+}
+
+bool JSONArrayElementReader::number_integer(nlohmann::json::number_integer_t val)
+{
+    return this->put(val);
+}
+
+bool JSONArrayElementReader::number_unsigned(nlohmann::json::number_unsigned_t val)
+{
+    return this->put(val);
+}
+
+bool JSONArrayElementReader::number_float(nlohmann::json::number_float_t val, const nlohmann::json::string_t &)
+{
+    return this->put(val);
+}
+
+bool JSONArrayElementReader::string(nlohmann::json::string_t &val)
+{
+    return this->put(std::move(val));
+}
+
+bool JSONArrayElementReader::binary(nlohmann::json::binary_t &val)
+{
+    return this->put(nlohmann::json::binary_t(std::move(val)));
+}
+
+bool JSONArrayElementReader::start_object(size_t)
+{
+    return this->start_container(nlohmann::json::object());
+}
+
+bool JSONArrayElementReader::key(nlohmann::json::string_t &val)
+{
+    if (!this->containers.empty()) {
+        this->element_key = std::move(val);
+    } else if (this->depth == 1) {
+        this->root_key = std::move(val);
+    }
+
+    return true;
+}
+
+bool JSONArrayElementReader::end_object()
+{
+    return this->end_container();
+}
+
+bool JSONArrayElementReader::start_array(size_t)
+{
+    if (this->containers.empty() && (this->depth == 1) && (this->root_key == this->keyname)) {
+        this->is_reading_array = true;
+        this->depth++;
+        return true;
+    }
+
+    return this->start_container(nlohmann::json::array());
+}
+
+bool JSONArrayElementReader::end_array()
+{
+    if (this->containers.empty() && this->is_reading_array && (this->depth == 2)) {
+        this->is_reading_array = false;
+        this->depth--;
+        return true;
+    }
+
+    return this->end_container();
+}
+
+/*!
+ * @brief 構文エラーを例外として送出する
+ * @details 呼び出し元の nlohmann::json::parse() と同じ例外となるようにするため.
+ */
+bool JSONArrayElementReader::parse_error(size_t, const std::string &, const nlohmann::json::exception &ex)
+{
+    throw ex;
+}
+
+/*!
+ * @brief 読んだ値を構築中の要素に加える
+ * @param value 読んだ値
+ * @return 解析を続けるか否か (常にtrue)
+ */
+bool JSONArrayElementReader::put(nlohmann::json &&value)
+{
+    if (this->containers.empty()) {
+        if (this->is_reading_array && (this->depth == 2)) {
+            this->handler(value);
+        }
+
+        return true;
+    }
+
+    auto &container = *this->containers.back();
+    if (container.is_object()) {
+        container[this->element_key] = std::move(value);
+    } else {
+        container.push_back(std::move(value));
+    }
+
+    return true;
+}
+
+/*!
+ * @brief オブジェクト/配列の開始を処理する
+ * @param container 空のオブジェクト/配列
+ * @return 解析を続けるか否か (常にtrue)
+ */
+bool JSONArrayElementReader::start_container(nlohmann::json &&container)
+{
+    if (!this->containers.empty()) {
+        auto &parent = *this->containers.back();
+        if (parent.is_object()) {
+            this->containers.push_back(&(parent[this->element_key] = std::move(container)));
+        } else {
+            parent.push_back(std::move(container));
+            this->containers.push_back(&parent.back());
+        }
+    } else if (this->is_reading_array && (this->depth == 2)) {
+        this->element = std::move(container);
+        this->containers.push_back(&this->element);
+    }
+
+    this->depth++;
+    return true;
+}
+
+/*!
+ * @brief オブジェクト/配列の終了を処理する
+ * @return 解析を続けるか否か (常にtrue)
+ * @details 要素が完成したらコールバックを呼び出し、要素を破棄する.
+ */
+bool JSONArrayElementReader::end_container()
+{
+    this->depth--;
+    if (this->containers.empty()) {
+        return true;
+    }
+
+    this->containers.pop_back();
+    if (this->containers.empty()) {
+        this->handler(this->element);
+        this->element = nullptr;
+    }
+
+    return true;
+}
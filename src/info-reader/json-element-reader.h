@@ -0,0 +1,50 @@
+#pragma once
+
+#include "external-lib/include-json.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * @brief 定義ファイルの配列要素を1つずつ取り出すSAXハンドラ
+ * @details
+ * ルートオブジェクトの指定したキーが持つ配列について、要素を1つ構築する毎にコールバックを呼び出し、
+ * 呼び出し後に破棄する. ファイル全体のDOMを構築しないため、解析中のメモリ使用量は要素1つ分で済む.
+ * それ以外の値は読み飛ばす.
+ * JSONテキストとMessagePackのどちらの nlohmann::json::sax_parse() にも渡せる.
+ */
+class JSONArrayElementReader {
+public:
+    using ElementHandler = std::function<void(nlohmann::json &)>;
+
+    JSONArrayElementReader(std::string_view keyname, ElementHandler handler);
+
+    bool null();
+    bool boolean(bool val);
+    bool number_integer(nlohmann::json::number_integer_t val);
+    bool number_unsigned(nlohmann::json::number_unsigned_t val);
+    bool number_float(nlohmann::json::number_float_t val, const nlohmann::json::string_t &s);
+    bool string(nlohmann::json::string_t &val);
+    bool binary(nlohmann::json::binary_t &val);
+    bool start_object(size_t elements);
+    bool key(nlohmann::json::string_t &val);
+    bool end_object();
+    bool start_array(size_t elements);
+    bool end_array();
+    bool parse_error(size_t position, const std::string &last_token, const nlohmann::json::exception &ex);
+
+private:
+    std::string keyname; //!< 要素を取り出す配列のキー
+    ElementHandler handler; //!< 要素毎に呼び出す処理
+    int depth = 0; //!< 現在開いているオブジェクト/配列の数
+    bool is_reading_array = false; //!< 要素を取り出す配列の中を読んでいるか否か
+    std::string root_key; //!< ルートオブジェクトで直前に読んだキー
+    std::string element_key; //!< 構築中のオブジェクトで直前に読んだキー
+    nlohmann::json element; //!< 構築中の要素
+    std::vector<nlohmann::json *> containers; //!< 構築中の要素内で開いているオブジェクト/配列
+
+    bool put(nlohmann::json &&value);
+    bool start_container(nlohmann::json &&container);
+    bool end_container();
+};
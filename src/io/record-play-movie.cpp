@@ -10,13 +10,19 @@
 #include "core/asking-player.h"
 #include "io/files-util.h"
 #include "io/signal-handlers.h"
+#include "io/term-delta-stream.h"
 #include "locale/japanese.h"
 #include "system/player-type-definition.h"
 #include "term/gameterm.h"
+#include "term/term-color-types.h"
 #include "term/z-form.h"
 #include "util/angband-files.h"
+#include "util/int-char-converter.h"
 #include "view/display-messages.h"
+#include "world/world.h"
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <sstream>
 #include <vector>
 
@@ -24,7 +30,9 @@
 #include <windows.h>
 #define WAIT 100
 #else
+#include "main-unix/spectator-broadcaster.h"
 #include "system/h-basic.h"
+#include <memory>
 #ifdef HAVE_SYS_TIME_H
 #include <sys/time.h>
 #endif
@@ -35,13 +43,44 @@
 #define FRESH_QUEUE_SIZE 4096
 #define DEFAULT_DELAY 50
 #define RECVBUF_SIZE 1024
-/* 「n」、「t」、および「w」コマンドでは、長さが「signed char」に配置されるときに負の値を回避するために、これよりも長い長さを使用しないでください。 */
-static constexpr auto SPLIT_MAX = 127;
+#define KEYFRAME_INTERVAL 300 /* 録画ファイルにキーフレームを挟む間隔(100ms単位) */
+#define KEYFRAME_BYTES 256 * 1024 /* 差分がこれだけ溜まったら間隔に達していなくてもキーフレームを挟む */
+#define MOVIE_READ_SIZE 64 * 1024 /* バイナリ形式のムービーを一度に読む量 */
+#define MAX_PLAYBACK_SPEED 256 /* 早送りの最大倍率 */
 
 static long epoch_time; /* バッファ開始時刻 */
 static int browse_delay; /* 表示するまでの時間(100ms単位)(この間にラグを吸収する) */
 static int movie_fd;
 static int movie_mode;
+static bool is_term_delta_movie; /* 再生するムービーがバイナリ形式か (古い形式はテキスト) */
+
+/* バイナリ形式のムービーの再生状態 */
+static struct {
+    TermDeltaDecoder decoder{};
+    TermDeltaIndex index{}; /* キーフレームの索引 */
+    bool is_seekable = false; /* 索引を使って再生位置を変えられるか */
+    std::string buffer{}; /* 読み込んだデータ */
+    size_t position = 0; /* buffer のうち次に描画するフレームの位置 */
+    size_t frame_size = 0; /* 次に描画するフレームのバイト数 */
+    bool is_end = false; /* 最後のフレームまで読んだか */
+    int speed = 1; /* 再生速度の倍率 */
+    long base_time = 0; /* 再生位置か再生速度を最後に変えた時刻 */
+    long base_movie_time = 0; /* その時点の再生位置 (ムービーのタイムスタンプ) */
+    TERM_LEN cursor_x = 0;
+    TERM_LEN cursor_y = 0;
+} playback;
+
+static TermDeltaEncoder stream_encoder; /* 録画・配信する画面の差分 */
+static long stream_epoch_time; /* 録画・配信を始めた時刻 */
+static bool movie_needs_keyframe; /* 録画ファイルに次に書くのはキーフレームか */
+static uint64_t movie_offset; /* 録画ファイルに書いたバイト数 */
+static uint32_t movie_keyframe_time; /* 録画ファイルに最後にキーフレームを書いた時刻 */
+static uint64_t movie_keyframe_offset; /* 録画ファイルに最後に書いたキーフレームの位置 */
+static TermDeltaIndex movie_index; /* 録画ファイルのキーフレームの索引 */
+static bool is_chuukei_hooked;
+#ifndef WINDOWS
+static std::unique_ptr<SpectatorBroadcaster> spectator_broadcaster;
+#endif
 
 /* 描画する時刻を覚えておくキュー構造体 */
 static struct {
@@ -75,6 +114,7 @@ static void disable_chuukei_server(void)
     t->bigcurs_hook = old_bigcurs_hook;
     t->wipe_hook = old_wipe_hook;
     t->text_hook = old_text_hook;
+    is_chuukei_hooked = false;
 }
 
 /* ANSI Cによればstatic変数は0で初期化されるが一応初期化する */
@@ -107,15 +147,6 @@ static long get_current_time(void)
  */
 static errr insert_ringbuf(std::string_view header, std::string_view payload = "")
 {
-    if (movie_mode) {
-        fd_write(movie_fd, header.data(), header.length());
-        if (!payload.empty()) {
-            fd_write(movie_fd, payload.data(), payload.length());
-        }
-        fd_write(movie_fd, "", 1);
-        return 0;
-    }
-
     /* バッファをオーバー */
     auto all_length = header.length() + payload.length();
     if (ring.inlen + all_length + 1 >= RINGBUF_SIZE) {
@@ -161,124 +192,148 @@ static errr insert_ringbuf(std::string_view header, std::string_view payload = "
     return 0;
 }
 
-/* strが同じ文字の繰り返しかどうか調べる */
-static bool string_is_repeat(concptr str, int len)
+/* 録画・配信を始めてからの時間を100ms単位で取得する */
+static uint32_t get_stream_time()
 {
-    char c = str[0];
-    int i;
+    return static_cast<uint32_t>(get_current_time() - stream_epoch_time);
+}
 
-    if (len < 2) {
-        return false;
-    }
-#ifdef JP
-    if (iskanji(c)) {
-        return false;
+/* メインウィンドウの大きさが変わっていたら画面の写しを作り直す */
+static void sync_stream_size()
+{
+    const auto *t = angband_terms[0];
+    if ((t->wid != stream_encoder.get_width()) || (t->hgt != stream_encoder.get_height())) {
+        stream_encoder.resize(t->wid, t->hgt);
     }
-#endif
+}
 
-    for (i = 1; i < len; i++) {
-#ifdef JP
-        if (c != str[i] || iskanji(str[i])) {
-            return false;
-        }
-#else
-        if (c != str[i]) {
-            return false;
-        }
-#endif
-    }
+/* 録画ファイルに書き、書いたバイト数を数える */
+static void write_movie(std::string_view data)
+{
+    fd_write(movie_fd, data.data(), data.length());
+    movie_offset += data.length();
+}
 
-    return true;
+/*!
+ * @brief 録画ファイルの末尾に索引を書いて閉じる
+ * @details フックは外さないので、ゲームの終了時にも呼べる
+ */
+static void finish_movie_recording()
+{
+    movie_index.set_end_time(get_stream_time());
+    const auto trailer = movie_index.encode_trailer(movie_offset);
+    fd_write(movie_fd, trailer.data(), trailer.length());
+    fd_close(movie_fd);
+    movie_mode = 0;
 }
 
-#ifdef JP
-/* マルチバイト文字を分割せずに str を分割する長さを len 以下で返す */
-static int find_split(concptr str, int len)
-{
-    /*
-     * SJIS が定義されている場合でも、str は常に EUC-JP としてエンコードされます。
-     * 他の場所で行われているような 3 バイトのエンコーディングは想定していません。
-     */
-    int last_split = 0, i = 0;
-    while (i < len) {
-        if (iseuckanji(str[i])) {
-            if (i < len - 1) {
-                last_split = i + 2;
-            }
-            i += 2;
-        } else {
-            last_split = i + 1;
-            ++i;
+/* 録画したままゲームを終了した場合も索引を書く */
+static const struct MovieRecordingFinisher {
+    ~MovieRecordingFinisher()
+    {
+        if (movie_mode) {
+            finish_movie_recording();
         }
     }
-    return last_split;
-}
-#endif
+} movie_recording_finisher;
 
-static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+/*!
+ * @brief 1フレーム分の差分を録画ファイルと観戦者に送る
+ * @details キーフレームは録画を始めた直後や観戦者が追いつけなかった場合など、必要なときだけ作る
+ */
+static void send_stream_frame()
 {
-    if (len == 1) {
-        insert_ringbuf(format("s%c%c%c%c", x + 1, y + 1, col, *str));
-        return (*old_text_hook)(x, y, len, col, str);
-    }
-
-    if (string_is_repeat(str, len)) {
-        while (len > SPLIT_MAX) {
-            insert_ringbuf(format("n%c%c%c%c%c", x + 1, y + 1, SPLIT_MAX, col, *str));
-            x += SPLIT_MAX;
-            len -= SPLIT_MAX;
+    sync_stream_size();
+    const auto time = get_stream_time();
+    const auto turn = static_cast<uint32_t>(AngbandWorld::get_instance().game_turn);
+    const auto delta = stream_encoder.encode_delta(time);
+    std::string keyframe;
+    const auto make_keyframe = [&keyframe, time, turn]() -> std::string_view {
+        if (keyframe.empty()) {
+            keyframe = stream_encoder.encode_keyframe(time, turn);
         }
 
-        std::string formatted_text;
-        if (len > 1) {
-            formatted_text = format("n%c%c%c%c%c", x + 1, y + 1, len, col, *str);
+        return keyframe;
+    };
+
+    if (movie_mode) {
+        if (movie_needs_keyframe || (time - movie_keyframe_time >= KEYFRAME_INTERVAL) || (movie_offset - movie_keyframe_offset >= KEYFRAME_BYTES)) {
+            movie_index.add({ time, turn, movie_offset });
+            movie_keyframe_time = time;
+            movie_keyframe_offset = movie_offset;
+            write_movie(make_keyframe());
         } else {
-            formatted_text = format("s%c%c%c%c", x + 1, y + 1, col, *str);
+            write_movie(delta);
         }
 
-        insert_ringbuf(formatted_text);
-        return (*old_text_hook)(x, y, len, col, str);
+        movie_needs_keyframe = false;
     }
 
-#if defined(SJIS) && defined(JP)
-    std::string buffer = str; // strは書き換わって欲しくないのでコピーする.
-    auto *payload = buffer.data();
-    sjis2euc(payload);
-#else
-    const auto *payload = str;
+#ifndef WINDOWS
+    if (spectator_broadcaster) {
+        spectator_broadcaster->broadcast(delta, make_keyframe);
+    }
 #endif
-    while (len > SPLIT_MAX) {
-        auto split_len = _(find_split(payload, SPLIT_MAX), SPLIT_MAX);
-        insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, split_len, col), std::string_view(payload, split_len));
-        x += split_len;
-        len -= split_len;
-        payload += split_len;
+}
+
+#ifndef WINDOWS
+/* 入力待ちの間に観戦者の接続を受け付け、送り残しを送る */
+static void poll_spectators()
+{
+    if (!spectator_broadcaster) {
+        return;
     }
 
-    insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, len, col), std::string_view(payload, len));
+    std::string keyframe;
+    spectator_broadcaster->poll([&keyframe]() -> std::string_view {
+        keyframe = stream_encoder.encode_keyframe(get_stream_time(), AngbandWorld::get_instance().game_turn);
+        return keyframe;
+    });
+}
+#endif
+
+static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+{
+    sync_stream_size();
+#if defined(SJIS) && defined(JP)
+    std::string buffer(str, len); // strは書き換わって欲しくないのでコピーする.
+    sjis2euc(buffer.data());
+    stream_encoder.put_text(x, y, len, col, buffer.data());
+#else
+    stream_encoder.put_text(x, y, len, col, str);
+#endif
     return (*old_text_hook)(x, y, len, col, str);
 }
 
 static errr send_wipe_to_chuukei_server(int x, int y, int len)
 {
-    while (len > SPLIT_MAX) {
-        insert_ringbuf(format("w%c%c%c", x + 1, y + 1, SPLIT_MAX));
-        x += SPLIT_MAX;
-        len -= SPLIT_MAX;
-    }
-    insert_ringbuf(format("w%c%c%c", x + 1, y + 1, len));
-
+    sync_stream_size();
+    stream_encoder.wipe(x, y, len);
     return (*old_wipe_hook)(x, y, len);
 }
 
 static errr send_xtra_to_chuukei_server(int n, int v)
 {
-    if (n == TERM_XTRA_CLEAR || n == TERM_XTRA_FRESH || n == TERM_XTRA_SHAPE) {
-        insert_ringbuf(format("x%c", n + 1));
-
-        if (n == TERM_XTRA_FRESH) {
-            insert_ringbuf("d", std::to_string(get_current_time() - epoch_time));
-        }
+    switch (n) {
+    case TERM_XTRA_CLEAR:
+        sync_stream_size();
+        stream_encoder.clear();
+        break;
+    case TERM_XTRA_SHAPE:
+        stream_encoder.set_cursor_shape(v);
+        break;
+    case TERM_XTRA_FRESH:
+        send_stream_frame();
+        break;
+#ifndef WINDOWS
+    case TERM_XTRA_EVENT:
+    case TERM_XTRA_BORED:
+    case TERM_XTRA_DELAY:
+        poll_spectators();
+        break;
+#endif
+    default:
+        break;
     }
 
     /* Verify the hook */
@@ -291,15 +346,13 @@ static errr send_xtra_to_chuukei_server(int n, int v)
 
 static errr send_curs_to_chuukei_server(int x, int y)
 {
-    insert_ringbuf(format("c%c%c", x + 1, y + 1));
-
+    stream_encoder.move_cursor(x, y, false);
     return (*old_curs_hook)(x, y);
 }
 
 static errr send_bigcurs_to_chuukei_server(int x, int y)
 {
-    insert_ringbuf(format("C%c%c", x + 1, y + 1));
-
+    stream_encoder.move_cursor(x, y, true);
     return (*old_bigcurs_hook)(x, y);
 }
 
@@ -323,6 +376,29 @@ void prepare_chuukei_hooks(void)
     t0->bigcurs_hook = send_bigcurs_to_chuukei_server;
     t0->wipe_hook = send_wipe_to_chuukei_server;
     t0->text_hook = send_text_to_chuukei_server;
+
+    is_chuukei_hooked = true;
+    stream_epoch_time = get_current_time();
+    stream_encoder.resize(t0->wid, t0->hgt);
+}
+
+/* 録画も配信もしていなければフックを外し、どちらかをしていればフックを掛ける */
+static void update_chuukei_hooks()
+{
+#ifdef WINDOWS
+    const auto is_streaming = movie_mode != 0;
+#else
+    const auto is_streaming = (movie_mode != 0) || (spectator_broadcaster != nullptr);
+#endif
+    if (is_streaming == is_chuukei_hooked) {
+        return;
+    }
+
+    if (is_streaming) {
+        prepare_chuukei_hooks();
+    } else {
+        disable_chuukei_server();
+    }
 }
 
 /*
@@ -333,9 +409,8 @@ void prepare_movie_hooks(PlayerType *player_ptr)
     TermCenteredOffsetSetter tcos(std::nullopt, std::nullopt);
 
     if (movie_mode) {
-        movie_mode = 0;
-        disable_chuukei_server();
-        fd_close(movie_fd);
+        finish_movie_recording();
+        update_chuukei_hooks();
         msg_print(_("録画を終了しました。", "Stopped recording."));
         return;
     }
@@ -366,13 +441,17 @@ void prepare_movie_hooks(PlayerType *player_ptr)
         movie_fd = fd_make(path);
     }
 
-    if (!movie_fd) {
+    if (movie_fd < 0) {
         msg_print(_("ファイルを開けません！", "Can not open file."));
         return;
     }
 
+    movie_offset = 0;
+    movie_index = TermDeltaIndex();
+    write_movie(TERM_DELTA_STREAM_HEADER);
     movie_mode = 1;
-    prepare_chuukei_hooks();
+    movie_needs_keyframe = true;
+    update_chuukei_hooks();
     do_cmd_redraw(player_ptr);
 }
 
@@ -614,9 +693,377 @@ static bool flush_ringbuf_client()
     return true;
 }
 
+/*!
+ * @brief ムービーの先頭を読み、バイナリ形式かどうかを調べる
+ * @details 古いテキスト形式のファイルは先頭から読み直す
+ */
+static void check_movie_format()
+{
+    std::array<char, TERM_DELTA_STREAM_HEADER.size()> header{};
+    size_t read_size = 0;
+    while ((movie_fd >= 0) && (read_size < header.size())) {
+        const auto size = read(movie_fd, header.data() + read_size, header.size() - read_size);
+        if (size <= 0) {
+            break;
+        }
+
+        read_size += size;
+    }
+
+    is_term_delta_movie = std::string_view(header.data(), read_size) == TERM_DELTA_STREAM_HEADER;
+    if (!is_term_delta_movie && (movie_fd >= 0)) {
+        (void)fd_seek(movie_fd, 0);
+    }
+}
+
+/*!
+ * @brief 次に描画するフレームを読む
+ * @return フレーム. ムービーの終わりに達した場合はstd::nullopt
+ * @details 読んだフレームは skip_movie_frame() を呼ぶまで次のフレームにならない
+ */
+static std::optional<TermDeltaFrame> peek_movie_frame()
+{
+    while (!playback.is_end) {
+        const auto frame = TermDeltaDecoder::read_frame(std::string_view(playback.buffer).substr(playback.position), playback.frame_size);
+        if (frame) {
+            if (frame->type != TermDeltaFrameType::INDEX) {
+                return frame;
+            }
+
+            playback.is_end = true;
+            break;
+        }
+
+        playback.buffer.erase(0, playback.position);
+        playback.position = 0;
+        const auto buffered_size = playback.buffer.size();
+        playback.buffer.resize(buffered_size + MOVIE_READ_SIZE);
+        const auto recv_bytes = read(movie_fd, playback.buffer.data() + buffered_size, MOVIE_READ_SIZE);
+        playback.buffer.resize(buffered_size + std::max<int>(recv_bytes, 0));
+        if (recv_bytes <= 0) {
+            playback.is_end = true;
+            break;
+        }
+    }
+
+    return std::nullopt;
+}
+
+static void skip_movie_frame()
+{
+    playback.position += playback.frame_size;
+}
+
+/*!
+ * @brief 索引のない録画ファイルのフレームを先頭から辿って索引を作る
+ * @details フレームの長さを辿るだけで、キーフレームの最初の命令 (ゲームターン) 以外は復号しない
+ */
+static void scan_movie_index()
+{
+    uint64_t offset = TERM_DELTA_STREAM_HEADER.size();
+    while (const auto frame = peek_movie_frame()) {
+        if (frame->type == TermDeltaFrameType::KEY) {
+            playback.decoder.start_frame(frame->ops);
+            const auto op = playback.decoder.next_op();
+            const auto turn = (op && (op->type == TermDeltaOpType::TURN)) ? static_cast<uint32_t>(op->n) : 0;
+            playback.index.add({ frame->time, turn, offset });
+        }
+
+        playback.index.set_end_time(frame->time);
+        offset += playback.frame_size;
+        skip_movie_frame();
+    }
+}
+
+/*!
+ * @brief 録画ファイルのキーフレームの索引を読む
+ * @param path 録画ファイルのパス
+ * @details 末尾に索引がないファイル (録画中にゲームが落ちた場合など) は索引を作り直す
+ */
+static void load_movie_index(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    const auto file_size = std::filesystem::file_size(path, ec);
+    if (!is_term_delta_movie || ec) {
+        return;
+    }
+
+    playback.is_seekable = true;
+    std::string footer(TermDeltaIndex::FOOTER_SIZE, '\0');
+    std::optional<uint64_t> index_offset;
+    if ((file_size >= TERM_DELTA_STREAM_HEADER.size() + footer.size()) && (fd_seek(movie_fd, file_size - footer.size()) == 0) && (fd_read(movie_fd, footer.data(), footer.size()) == 0)) {
+        index_offset = TermDeltaIndex::read_footer(footer);
+    }
+
+    auto is_loaded = false;
+    if (index_offset && (*index_offset < file_size - footer.size()) && (fd_seek(movie_fd, *index_offset) == 0)) {
+        std::string trailer(file_size - footer.size() - *index_offset, '\0');
+        size_t frame_size = 0;
+        if (fd_read(movie_fd, trailer.data(), trailer.size()) == 0) {
+            const auto frame = TermDeltaDecoder::read_frame(trailer, frame_size);
+            try {
+                if (frame && (frame->type == TermDeltaFrameType::INDEX)) {
+                    playback.index = TermDeltaIndex::decode(*frame);
+                    is_loaded = true;
+                }
+            } catch (const std::exception &) {
+                playback.index = {};
+            }
+        }
+    }
+
+    (void)fd_seek(movie_fd, TERM_DELTA_STREAM_HEADER.size());
+    if (is_loaded) {
+        return;
+    }
+
+    try {
+        scan_movie_index();
+    } catch (const std::exception &) {
+        // 壊れたフレームの手前までの索引で移動できるようにし、再生がそこに達したら browse_movie() で報告する
+    }
+
+    playback.buffer.clear();
+    playback.position = 0;
+    playback.is_end = false;
+    (void)fd_seek(movie_fd, TERM_DELTA_STREAM_HEADER.size());
+}
+
+/* 現在の再生位置 (ムービーのタイムスタンプ) を返す */
+static long get_playback_time()
+{
+    return playback.base_movie_time + (get_current_time() - playback.base_time) * playback.speed;
+}
+
+static void set_playback_time(long movie_time)
+{
+    playback.base_time = get_current_time();
+    playback.base_movie_time = movie_time;
+}
+
+/* バイナリ形式のムービーの文字列を仮想画面に書く */
+static void put_movie_text(TERM_LEN x, TERM_LEN y, TERM_COLOR col, std::string text)
+{
+    const auto len = static_cast<int>(text.length());
+#ifndef WINDOWS
+    win2unix(col, text.data());
+#endif
+#if defined(SJIS) && defined(JP)
+    euc2sjis(text.data());
+#endif
+    update_term_size(x, y, len);
+    term_putstr(x, y, len, col, text);
+}
+
+/*!
+ * @brief バイナリ形式のムービーの1フレームを仮想画面に反映する
+ * @param ops フレームの命令の列
+ * @details 実際に描画するのは term_fresh() を呼んだときなので、早送りやシークでは途中のフレームを描画しない
+ */
+static void apply_movie_frame(std::string_view ops)
+{
+    playback.decoder.start_frame(ops);
+    while (const auto op = playback.decoder.next_op()) {
+        switch (op->type) {
+        case TermDeltaOpType::SIZE:
+            if ((op->x > 0) && (op->y > 0)) {
+                update_term_size(op->x - 1, op->y - 1, 1);
+            }
+
+            break;
+        case TermDeltaOpType::CLEAR:
+            term_clear();
+            break;
+        case TermDeltaOpType::TEXT:
+            put_movie_text(op->x, op->y, op->attr, std::string(op->text));
+            break;
+        case TermDeltaOpType::REPEAT:
+            put_movie_text(op->x, op->y, op->attr, std::string(op->n, op->text.front()));
+            break;
+        case TermDeltaOpType::WIPE:
+            update_term_size(op->x, op->y, op->n);
+            term_erase(op->x, op->y, op->n);
+            break;
+        case TermDeltaOpType::CURSOR:
+            playback.cursor_x = op->x;
+            playback.cursor_y = op->y;
+            break;
+        case TermDeltaOpType::SHAPE:
+            term_set_cursor(op->n);
+            break;
+        case TermDeltaOpType::TURN:
+            break;
+        }
+    }
+
+    term_gotoxy(playback.cursor_x, playback.cursor_y);
+}
+
+/*!
+ * @brief 再生位置を変える
+ * @param movie_time 新しい再生位置 (ムービーのタイムスタンプ)
+ * @details 索引で直前のキーフレームを探し、そこから目的の時刻までのフレームを仮想画面に反映して最後に1回だけ描画する
+ */
+static void seek_movie(long movie_time)
+{
+    movie_time = std::clamp<long>(movie_time, 0, playback.index.get_end_time());
+    const auto *entry = playback.index.find_by_time(static_cast<uint32_t>(movie_time));
+    if (!playback.is_seekable || (entry == nullptr) || (fd_seek(movie_fd, entry->offset) != 0)) {
+        return;
+    }
+
+    playback.buffer.clear();
+    playback.position = 0;
+    playback.is_end = false;
+    auto is_keyframe = true;
+    while (const auto frame = peek_movie_frame()) {
+        if (!is_keyframe && (frame->time > movie_time)) {
+            break;
+        }
+
+        apply_movie_frame(frame->ops);
+        skip_movie_frame();
+        is_keyframe = false;
+    }
+
+    term_fresh();
+    set_playback_time(movie_time);
+}
+
+/*!
+ * @brief 再生中のキー入力を処理する
+ * @return 再生を続けるか
+ * @details
+ * ESC/q: 終了, +/-: 再生速度を2倍/半分, h/l (4/6): 1分戻る/進む, H/L: 10分戻る/進む,
+ * g/G: 最初/最後へ移動, t: 時刻(分)を指定して移動, T: ゲームターンを指定して移動
+ */
+static bool process_movie_key()
+{
+    char key;
+    if (term_inkey(&key, false, true) != 0) {
+        return true;
+    }
+
+    auto now = get_playback_time();
+    if (playback.is_seekable) {
+        now = std::min<long>(now, playback.index.get_end_time());
+    }
+
+    switch (key) {
+    case ESCAPE:
+    case 'q':
+        return false;
+    case '+':
+        set_playback_time(now);
+        playback.speed = std::min(playback.speed * 2, MAX_PLAYBACK_SPEED);
+        break;
+    case '-':
+        set_playback_time(now);
+        playback.speed = std::max(playback.speed / 2, 1);
+        break;
+    case 'h':
+    case '4':
+        seek_movie(now - 600);
+        break;
+    case 'l':
+    case '6':
+        seek_movie(now + 600);
+        break;
+    case 'H':
+        seek_movie(now - 6000);
+        break;
+    case 'L':
+        seek_movie(now + 6000);
+        break;
+    case 'g':
+        seek_movie(0);
+        break;
+    case 'G':
+        seek_movie(playback.index.get_end_time());
+        break;
+    case 't': {
+        if (!playback.is_seekable) {
+            break;
+        }
+
+        const auto minutes = input_integer(_("移動する時刻(分): ", "Minutes: "), 0, playback.index.get_end_time() / 600, now / 600);
+        seek_movie(minutes ? *minutes * 600L : now);
+        break;
+    }
+    case 'T': {
+        if (!playback.is_seekable) {
+            break;
+        }
+
+        const auto turn = input_integer(_("移動するゲームターン: ", "Game turn: "), 0, std::numeric_limits<int>::max());
+        const auto *entry = turn ? playback.index.find_by_turn(*turn) : nullptr;
+        seek_movie(entry ? entry->time : now);
+        break;
+    }
+    default:
+        break;
+    }
+
+    return true;
+}
+
+/*!
+ * @brief バイナリ形式のムービーを記録された時間の通りに再生する
+ * @details
+ * 再生位置に追いつくまでフレームを仮想画面に反映し、追いついたところで描画するので、早送り中は途中のフレームを描画しない.
+ * 録画ファイルは最後まで再生しても終了キーを押すまで再生位置を変えられる.
+ * 観戦用のソケットから読む場合は、受け取ったフレームを受け取った順に描画する.
+ */
+static void browse_term_delta_movie()
+{
+    if (const auto frame = peek_movie_frame()) {
+        set_playback_time(static_cast<long>(frame->time) - browse_delay);
+    }
+
+    while (true) {
+        const auto frame = peek_movie_frame();
+        if (frame && (frame->time <= get_playback_time())) {
+            apply_movie_frame(frame->ops);
+            skip_movie_frame();
+            continue;
+        }
+
+        term_fresh();
+        if (!frame && !playback.is_seekable) {
+            return;
+        }
+
+        if (!process_movie_key()) {
+            return;
+        }
+
+#ifdef WINDOWS
+        Sleep(WAIT);
+#else
+        usleep(WAIT);
+#endif
+    }
+}
+
+/*!
+ * @brief 壊れたフレームを読んだことを表示し、キー入力を待つ
+ * @param e 復号で投げられた例外
+ */
+static void report_broken_movie(const std::exception &e)
+{
+    const auto message = format(_("ムービーが壊れています: %s", "Broken movie: %s"), e.what());
+    term_erase(0, 0, 255);
+    term_putstr(0, 0, -1, TERM_YELLOW, message);
+    term_fresh();
+    char key;
+    (void)term_inkey(&key, true, true);
+}
+
 void prepare_browse_movie_without_path_build(const std::filesystem::path &path)
 {
     movie_fd = fd_open(path, O_RDONLY);
+    check_movie_format();
+    load_movie_index(path);
     init_buffer();
 }
 
@@ -626,6 +1073,16 @@ void browse_movie(void)
     term_fresh();
     term_xtra(TERM_XTRA_REACT, 0);
 
+    if (is_term_delta_movie) {
+        try {
+            browse_term_delta_movie();
+        } catch (const std::exception &e) {
+            report_broken_movie(e);
+        }
+
+        return;
+    }
+
     while (read_movie_file() == 0) {
         while (fresh_queue.next != fresh_queue.tail) {
             if (!flush_ringbuf_client()) {
@@ -647,6 +1104,33 @@ void prepare_browse_movie_with_path_build(std::string_view filename)
 {
     const auto &path = path_build(ANGBAND_DIR_USER, filename);
     movie_fd = fd_open(path, O_RDONLY);
+    check_movie_format();
+    load_movie_index(path);
     init_buffer();
 }
+
+/*!
+ * @brief 配信しているゲームを観戦する準備をする
+ * @param socket_path 配信しているゲームの Unix ドメインソケットのパス
+ */
+void prepare_spectate_stream(std::string_view socket_path)
+{
+    movie_fd = connect_spectator_broadcaster(socket_path);
+    check_movie_format();
+    if (!is_term_delta_movie) {
+        quit("Invalid spectator stream.");
+    }
+
+    init_buffer();
+}
+
+/*!
+ * @brief メインウィンドウを観戦者に配信し始める
+ * @param socket_path 観戦者の接続を待ち受ける Unix ドメインソケットのパス
+ */
+void start_spectator_broadcast(std::string_view socket_path)
+{
+    spectator_broadcaster = std::make_unique<SpectatorBroadcaster>(socket_path, TERM_DELTA_STREAM_HEADER);
+    update_chuukei_hooks();
+}
 #endif
@@ -9,4 +9,6 @@ void prepare_browse_movie_without_path_build(const std::filesystem::path &path);
 void browse_movie();
 #ifndef WINDOWS
 void prepare_browse_movie_with_path_build(std::string_view filename);
+void prepare_spectate_stream(std::string_view socket_path);
+void start_spectator_broadcast(std::string_view socket_path);
 #endif
@@ -0,0 +1,653 @@
+/*!
+ * @file term-delta-stream.cpp
+ * @brief 端末の画面の差分をバイナリで符号化・復号する処理の実装
+ */
+
+#include "io/term-delta-stream.h"
+#include "system/angband-exceptions.h"
+#include "system/h-basic.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+/*!
+ * @brief 変わっていない桁をこの数まで挟んだ範囲は1つにまとめて送る (命令を分けるより短くなる)
+ */
+constexpr TERM_LEN MERGE_GAP = 3;
+
+/*!
+ * @brief 同じ文字がこの数以上続いたら繰り返しとして送る
+ */
+constexpr int MIN_REPEAT = 4;
+
+/*!
+ * @brief 復号する画面の幅と高さの上限 (壊れたストリームで巨大な画面を確保しないため)
+ */
+constexpr uint64_t MAX_SCREEN_LENGTH = 1024;
+
+void append_varint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<char>(value));
+}
+
+/*!
+ * @brief varint を読む
+ * @param in 読む位置. 読んだ分だけ進める
+ * @return 読んだ値. 途中で終わっている場合はstd::nullopt
+ */
+std::optional<uint64_t> read_varint(std::string_view &in)
+{
+    uint64_t value = 0;
+    for (auto i = 0; i < 10; i++) {
+        if (static_cast<size_t>(i) >= in.size()) {
+            return std::nullopt;
+        }
+
+        const auto byte = static_cast<uint8_t>(in[i]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            in.remove_prefix(i + 1);
+            return value;
+        }
+    }
+
+    THROW_EXCEPTION(std::runtime_error, "Too long varint in the movie stream.");
+}
+
+uint64_t read_op_varint(std::string_view &in)
+{
+    const auto value = read_varint(in);
+    if (!value) {
+        THROW_EXCEPTION(std::runtime_error, "Truncated op in the movie stream.");
+    }
+
+    return *value;
+}
+
+std::string make_frame(TermDeltaFrameType type, uint32_t time, std::string_view ops)
+{
+    std::string body;
+    append_varint(body, time);
+    body.append(ops);
+    std::string frame(1, static_cast<char>(type));
+    append_varint(frame, static_cast<uint32_t>(body.size()));
+    frame.append(body);
+    return frame;
+}
+
+/*!
+ * @brief 1文字が占める桁数を返す (全角文字の2バイト目から始めないため)
+ */
+TERM_LEN char_width([[maybe_unused]] char c, [[maybe_unused]] TERM_LEN x, [[maybe_unused]] TERM_LEN w)
+{
+#ifdef JP
+    if (iskanji(c) && (x + 1 < w)) {
+        return 2;
+    }
+#endif
+    return 1;
+}
+
+void write_span(std::string &ops, uint32_t &position, TermDeltaOpType type, uint32_t start, int n)
+{
+    ops.push_back(static_cast<char>(type));
+    append_varint(ops, start - position);
+    append_varint(ops, n);
+    position = start + n;
+}
+}
+
+TERM_LEN TermDeltaEncoder::get_width() const
+{
+    return this->width;
+}
+
+TERM_LEN TermDeltaEncoder::get_height() const
+{
+    return this->height;
+}
+
+/*!
+ * @brief 画面の大きさを変える. 画面の写しは消去し、次のフレームで大きさと消去を送る
+ */
+void TermDeltaEncoder::resize(TERM_LEN w, TERM_LEN h)
+{
+    this->width = w;
+    this->height = h;
+    this->current.assign(static_cast<size_t>(w) * h, Cell());
+    this->sent.assign(this->current.size(), Cell());
+    this->dirty_ranges.assign(h, { w, 0 });
+    this->is_resized = true;
+    this->is_cleared = true;
+    if ((this->cursor_x >= w) || (this->cursor_y >= h)) {
+        this->has_cursor = false;
+        this->is_cursor_moved = false;
+    }
+}
+
+void TermDeltaEncoder::mark_dirty(TERM_LEN x, TERM_LEN y, int n)
+{
+    auto &[x1, x2] = this->dirty_ranges[y];
+    x1 = std::min(x1, x);
+    x2 = std::max<TERM_LEN>(x2, x + n);
+}
+
+/*!
+ * @brief 文字列を画面の写しに書く
+ */
+void TermDeltaEncoder::put_text(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, const char *s)
+{
+    if ((y < 0) || (y >= this->height) || (x < 0) || (x >= this->width)) {
+        return;
+    }
+
+    n = std::min(n, this->width - x);
+    auto *cells = &this->current[static_cast<size_t>(y) * this->width + x];
+    for (auto i = 0; i < n; i++) {
+        cells[i] = { a, s[i] };
+    }
+
+    this->mark_dirty(x, y, n);
+}
+
+/*!
+ * @brief 画面の写しを空白で消す
+ */
+void TermDeltaEncoder::wipe(TERM_LEN x, TERM_LEN y, int n)
+{
+    if ((y < 0) || (y >= this->height) || (x < 0) || (x >= this->width)) {
+        return;
+    }
+
+    n = std::min(n, this->width - x);
+    std::fill_n(&this->current[static_cast<size_t>(y) * this->width + x], n, Cell());
+    this->mark_dirty(x, y, n);
+}
+
+/*!
+ * @brief 画面全体を消去する. 受け取る側も消去するので、これより前の内容は送らない
+ */
+void TermDeltaEncoder::clear()
+{
+    std::fill(this->current.begin(), this->current.end(), Cell());
+    std::fill(this->sent.begin(), this->sent.end(), Cell());
+    this->dirty_ranges.assign(this->height, { this->width, 0 });
+    this->is_cleared = true;
+}
+
+void TermDeltaEncoder::move_cursor(TERM_LEN x, TERM_LEN y, bool is_big)
+{
+    if ((y < 0) || (y >= this->height) || (x < 0) || (x >= this->width)) {
+        return;
+    }
+
+    this->cursor_x = x;
+    this->cursor_y = y;
+    this->is_big_cursor = is_big;
+    this->is_cursor_moved = true;
+    this->has_cursor = true;
+}
+
+void TermDeltaEncoder::set_cursor_shape(int shape)
+{
+    this->cursor_shape = shape;
+}
+
+/*!
+ * @brief 1行のうち base から変わった桁を命令に符号化する
+ * @param ops 命令の書き込み先
+ * @param position 直前の命令が書いた末尾の位置
+ * @param y 行
+ * @param row 行の内容
+ * @param base 受け取る側が持っている行の内容
+ * @param x1 調べる範囲の左端
+ * @param x2 調べる範囲の右端 (この桁は含まない)
+ */
+void TermDeltaEncoder::encode_row(std::string &ops, uint32_t &position, TERM_LEN y, const Cell *row, const Cell *base, TERM_LEN x1, TERM_LEN x2) const
+{
+    /* 全角文字の途中から始めないよう、日本語版では行頭から文字の区切りを辿る */
+#ifdef JP
+    TERM_LEN x = 0;
+#else
+    auto x = x1;
+#endif
+    auto start = -1;
+    auto end = -1;
+    while (x < x2) {
+        const auto w = char_width(row[x].c, x, this->width);
+        if ((x + w > x1) && !std::equal(row + x, row + x + w, base + x)) {
+            if ((start >= 0) && (x - end > MERGE_GAP)) {
+                this->encode_cells(ops, position, y, row, start, end);
+                start = -1;
+            }
+
+            if (start < 0) {
+                start = x;
+            }
+
+            end = x + w;
+        }
+
+        x += w;
+    }
+
+    if (start >= 0) {
+        this->encode_cells(ops, position, y, row, start, end);
+    }
+}
+
+/*!
+ * @brief 1行のうち範囲内の桁を全て命令に符号化する
+ * @details 空白の続きは WIPE、同じ属性の続きは同じ文字の繰り返しを REPEAT に、それ以外を TEXT にする
+ */
+void TermDeltaEncoder::encode_cells(std::string &ops, uint32_t &position, TERM_LEN y, const Cell *row, TERM_LEN x1, TERM_LEN x2) const
+{
+    const auto row_position = static_cast<uint32_t>(y) * this->width;
+    auto x = x1;
+    while (x < x2) {
+        if (row[x] == Cell()) {
+            auto wipe_end = x + 1;
+            while ((wipe_end < x2) && (row[wipe_end] == Cell())) {
+                wipe_end++;
+            }
+
+            write_span(ops, position, TermDeltaOpType::WIPE, row_position + x, wipe_end - x);
+            x = wipe_end;
+            continue;
+        }
+
+        /* 全角文字の2バイト目は属性が違っても1バイト目と一緒に送る */
+        const auto attr = row[x].a;
+        auto literal_start = x;
+        while ((x < x2) && (row[x] != Cell()) && (row[x].a == attr)) {
+            const auto w = char_width(row[x].c, x, this->width);
+            auto repeat_end = x + w;
+            if (w == 1) {
+                while ((repeat_end < x2) && (row[repeat_end] == row[x])) {
+                    repeat_end++;
+                }
+            }
+
+            if (repeat_end - x < MIN_REPEAT) {
+                x += w;
+                continue;
+            }
+
+            if (literal_start < x) {
+                write_span(ops, position, TermDeltaOpType::TEXT, row_position + literal_start, x - literal_start);
+                ops.push_back(static_cast<char>(attr));
+                for (auto i = literal_start; i < x; i++) {
+                    ops.push_back(row[i].c);
+                }
+            }
+
+            write_span(ops, position, TermDeltaOpType::REPEAT, row_position + x, repeat_end - x);
+            ops.push_back(static_cast<char>(attr));
+            ops.push_back(row[x].c);
+            x = repeat_end;
+            literal_start = x;
+        }
+
+        x = std::min(x, x2);
+        if (literal_start < x) {
+            write_span(ops, position, TermDeltaOpType::TEXT, row_position + literal_start, x - literal_start);
+            ops.push_back(static_cast<char>(attr));
+            for (auto i = literal_start; i < x; i++) {
+                ops.push_back(row[i].c);
+            }
+        }
+    }
+}
+
+/*!
+ * @brief 最後のフレームから変わった内容を差分フレームに符号化する
+ * @param time タイムスタンプ (100ms単位)
+ * @return 差分フレーム
+ */
+std::string TermDeltaEncoder::encode_delta(uint32_t time)
+{
+    std::string ops;
+    if (this->is_resized) {
+        ops.push_back(static_cast<char>(TermDeltaOpType::SIZE));
+        append_varint(ops, this->width);
+        append_varint(ops, this->height);
+    }
+
+    if (this->is_cleared) {
+        ops.push_back(static_cast<char>(TermDeltaOpType::CLEAR));
+    }
+
+    uint32_t position = 0;
+    for (TERM_LEN y = 0; y < this->height; y++) {
+        auto &[x1, x2] = this->dirty_ranges[y];
+        if (x1 >= x2) {
+            continue;
+        }
+
+        const auto offset = static_cast<size_t>(y) * this->width;
+        this->encode_row(ops, position, y, &this->current[offset], &this->sent[offset], x1, x2);
+        std::copy(this->current.begin() + offset + x1, this->current.begin() + offset + x2, this->sent.begin() + offset + x1);
+        x1 = this->width;
+        x2 = 0;
+    }
+
+    if (this->cursor_shape != this->sent_cursor_shape) {
+        ops.push_back(static_cast<char>(TermDeltaOpType::SHAPE));
+        append_varint(ops, this->cursor_shape);
+        this->sent_cursor_shape = this->cursor_shape;
+    }
+
+    if (this->is_cursor_moved) {
+        ops.push_back(static_cast<char>(TermDeltaOpType::CURSOR));
+        append_varint(ops, this->cursor_x);
+        append_varint(ops, this->cursor_y);
+        ops.push_back(this->is_big_cursor ? 1 : 0);
+    }
+
+    this->is_resized = false;
+    this->is_cleared = false;
+    this->is_cursor_moved = false;
+    return make_frame(TermDeltaFrameType::DELTA, time, ops);
+}
+
+/*!
+ * @brief 最後に符号化した画面全体をキーフレームに符号化する
+ * @param time タイムスタンプ (100ms単位)
+ * @param turn ゲームターン (索引のない録画ファイルでターンを指定して移動するために使う)
+ * @return キーフレーム
+ * @details 符号化していない変更は含まないので、差分フレームの直後に作れば差分フレームの代わりに送れる
+ */
+std::string TermDeltaEncoder::encode_keyframe(uint32_t time, uint32_t turn) const
+{
+    std::string ops;
+    ops.push_back(static_cast<char>(TermDeltaOpType::TURN));
+    append_varint(ops, turn);
+    ops.push_back(static_cast<char>(TermDeltaOpType::SIZE));
+    append_varint(ops, this->width);
+    append_varint(ops, this->height);
+    ops.push_back(static_cast<char>(TermDeltaOpType::CLEAR));
+    const std::vector<Cell> blank_row(this->width);
+    uint32_t position = 0;
+    for (TERM_LEN y = 0; y < this->height; y++) {
+        this->encode_row(ops, position, y, &this->sent[static_cast<size_t>(y) * this->width], blank_row.data(), 0, this->width);
+    }
+
+    ops.push_back(static_cast<char>(TermDeltaOpType::SHAPE));
+    append_varint(ops, this->sent_cursor_shape);
+    if (this->has_cursor) {
+        ops.push_back(static_cast<char>(TermDeltaOpType::CURSOR));
+        append_varint(ops, this->cursor_x);
+        append_varint(ops, this->cursor_y);
+        ops.push_back(this->is_big_cursor ? 1 : 0);
+    }
+
+    return make_frame(TermDeltaFrameType::KEY, time, ops);
+}
+
+/*!
+ * @brief バッファの先頭から1フレームを切り出す
+ * @param buffer 受け取ったデータ
+ * @param frame_size 切り出したフレームのバイト数を格納する
+ * @return 切り出したフレーム. フレームの途中までしか受け取っていない場合はstd::nullopt
+ */
+std::optional<TermDeltaFrame> TermDeltaDecoder::read_frame(std::string_view buffer, size_t &frame_size)
+{
+    if (buffer.empty()) {
+        return std::nullopt;
+    }
+
+    const auto type = static_cast<TermDeltaFrameType>(buffer.front());
+    if ((type != TermDeltaFrameType::DELTA) && (type != TermDeltaFrameType::KEY) && (type != TermDeltaFrameType::INDEX)) {
+        THROW_EXCEPTION(std::runtime_error, "Unknown frame in the movie stream.");
+    }
+
+    auto rest = buffer.substr(1);
+    const auto body_size = read_varint(rest);
+    if (!body_size || (rest.size() < *body_size)) {
+        return std::nullopt;
+    }
+
+    auto body = rest.substr(0, *body_size);
+    frame_size = buffer.size() - rest.size() + *body_size;
+    const auto time = read_varint(body);
+    if (!time) {
+        THROW_EXCEPTION(std::runtime_error, "Truncated frame in the movie stream.");
+    }
+
+    return TermDeltaFrame{ type, static_cast<uint32_t>(*time), body };
+}
+
+/*!
+ * @brief フレームの命令の復号を始める
+ * @param ops フレームの命令の列
+ */
+void TermDeltaDecoder::start_frame(std::string_view ops)
+{
+    this->rest = ops;
+    this->position = 0;
+}
+
+/*!
+ * @brief 次の命令を復号する
+ * @return 命令. フレームの終わりに達した場合はstd::nullopt
+ */
+std::optional<TermDeltaOp> TermDeltaDecoder::next_op()
+{
+    if (this->rest.empty()) {
+        return std::nullopt;
+    }
+
+    TermDeltaOp op;
+    op.type = static_cast<TermDeltaOpType>(this->rest.front());
+    this->rest.remove_prefix(1);
+    switch (op.type) {
+    case TermDeltaOpType::SIZE: {
+        const auto width = read_op_varint(this->rest);
+        const auto height = read_op_varint(this->rest);
+        if ((width == 0) || (width > MAX_SCREEN_LENGTH) || (height == 0) || (height > MAX_SCREEN_LENGTH)) {
+            THROW_EXCEPTION(std::runtime_error, "Invalid screen size in the movie stream.");
+        }
+
+        this->width = static_cast<TERM_LEN>(width);
+        this->height = static_cast<TERM_LEN>(height);
+        op.x = this->width;
+        op.y = this->height;
+        return op;
+    }
+    case TermDeltaOpType::CLEAR:
+        return op;
+    case TermDeltaOpType::TEXT:
+    case TermDeltaOpType::REPEAT:
+    case TermDeltaOpType::WIPE: {
+        const auto skip = read_op_varint(this->rest);
+        const auto length = read_op_varint(this->rest);
+        const auto width = static_cast<uint64_t>(this->width);
+        const auto screen_size = width * static_cast<uint64_t>(this->height);
+        if ((this->position >= screen_size) || (skip >= screen_size - this->position)) {
+            THROW_EXCEPTION(std::runtime_error, "Out of screen span in the movie stream.");
+        }
+
+        const auto start = this->position + skip;
+        if (length > width - start % width) {
+            THROW_EXCEPTION(std::runtime_error, "Out of screen span in the movie stream.");
+        }
+
+        op.x = static_cast<TERM_LEN>(start % width);
+        op.y = static_cast<TERM_LEN>(start / width);
+        op.n = static_cast<int>(length);
+        this->position = static_cast<uint32_t>(start + length);
+        if (op.type == TermDeltaOpType::WIPE) {
+            return op;
+        }
+
+        const size_t text_size = (op.type == TermDeltaOpType::TEXT) ? op.n : 1;
+        if (this->rest.size() < text_size + 1) {
+            THROW_EXCEPTION(std::runtime_error, "Truncated op in the movie stream.");
+        }
+
+        op.attr = static_cast<TERM_COLOR>(this->rest.front());
+        op.text = this->rest.substr(1, text_size);
+        this->rest.remove_prefix(text_size + 1);
+        return op;
+    }
+    case TermDeltaOpType::CURSOR: {
+        const auto x = read_op_varint(this->rest);
+        const auto y = read_op_varint(this->rest);
+        if ((x >= static_cast<uint64_t>(this->width)) || (y >= static_cast<uint64_t>(this->height))) {
+            THROW_EXCEPTION(std::runtime_error, "Out of screen cursor in the movie stream.");
+        }
+
+        if (this->rest.empty()) {
+            THROW_EXCEPTION(std::runtime_error, "Truncated op in the movie stream.");
+        }
+
+        op.x = static_cast<TERM_LEN>(x);
+        op.y = static_cast<TERM_LEN>(y);
+        op.n = this->rest.front();
+        this->rest.remove_prefix(1);
+        return op;
+    }
+    case TermDeltaOpType::SHAPE:
+    case TermDeltaOpType::TURN: {
+        const auto value = read_op_varint(this->rest);
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            THROW_EXCEPTION(std::runtime_error, "Too large value in the movie stream.");
+        }
+
+        op.n = static_cast<int>(static_cast<uint32_t>(value));
+        return op;
+    }
+    default:
+        THROW_EXCEPTION(std::runtime_error, "Unknown op in the movie stream.");
+    }
+}
+
+/*!
+ * @brief 録画ファイルの末尾のフッタから索引フレームの位置を読む
+ * @param footer ファイルの末尾の FOOTER_SIZE バイト
+ * @return 索引フレームの位置. フッタがない (録画が途中で終わった) 場合はstd::nullopt
+ */
+std::optional<uint64_t> TermDeltaIndex::read_footer(std::string_view footer)
+{
+    if ((footer.size() != FOOTER_SIZE) || !footer.ends_with(TERM_DELTA_INDEX_MAGIC)) {
+        return std::nullopt;
+    }
+
+    uint64_t offset = 0;
+    for (auto i = 0; i < 8; i++) {
+        offset |= static_cast<uint64_t>(static_cast<uint8_t>(footer[i])) << (8 * i);
+    }
+
+    return offset;
+}
+
+/*!
+ * @brief 索引フレームから索引を復号する
+ * @param frame 索引フレーム
+ * @return 索引
+ */
+TermDeltaIndex TermDeltaIndex::decode(const TermDeltaFrame &frame)
+{
+    if (frame.type != TermDeltaFrameType::INDEX) {
+        THROW_EXCEPTION(std::runtime_error, "Not an index frame in the movie stream.");
+    }
+
+    TermDeltaIndex index;
+    index.end_time = frame.time;
+    auto rest = frame.ops;
+    const auto count = read_op_varint(rest);
+    TermDeltaIndexEntry entry;
+    for (uint64_t i = 0; i < count; i++) {
+        entry.time += static_cast<uint32_t>(read_op_varint(rest));
+        entry.turn = static_cast<uint32_t>(read_op_varint(rest));
+        entry.offset += read_op_varint(rest);
+        index.entries.push_back(entry);
+    }
+
+    return index;
+}
+
+/*!
+ * @brief キーフレームを索引に加える. キーフレームはファイルの先頭から順に加えること
+ */
+void TermDeltaIndex::add(const TermDeltaIndexEntry &entry)
+{
+    this->entries.push_back(entry);
+    this->end_time = std::max(this->end_time, entry.time);
+}
+
+bool TermDeltaIndex::empty() const
+{
+    return this->entries.empty();
+}
+
+uint32_t TermDeltaIndex::get_end_time() const
+{
+    return this->end_time;
+}
+
+void TermDeltaIndex::set_end_time(uint32_t time)
+{
+    this->end_time = time;
+}
+
+/*!
+ * @brief 指定した時刻を描画するために再生を始めるキーフレームを探す
+ * @param time タイムスタンプ (100ms単位)
+ * @return 指定した時刻以前で最後のキーフレーム (最初のキーフレームより前なら最初のキーフレーム). 索引が空ならnullptr
+ */
+const TermDeltaIndexEntry *TermDeltaIndex::find_by_time(uint32_t time) const
+{
+    if (this->entries.empty()) {
+        return nullptr;
+    }
+
+    const auto it = std::upper_bound(this->entries.begin(), this->entries.end(), time, [](uint32_t t, const auto &entry) { return t < entry.time; });
+    return (it == this->entries.begin()) ? &*it : &*std::prev(it);
+}
+
+/*!
+ * @brief 指定したゲームターンを描画するために再生を始めるキーフレームを探す
+ * @param turn ゲームターン
+ * @return 指定したターン以前で最後のキーフレーム (最初のキーフレームより前なら最初のキーフレーム). 索引が空ならnullptr
+ */
+const TermDeltaIndexEntry *TermDeltaIndex::find_by_turn(uint32_t turn) const
+{
+    if (this->entries.empty()) {
+        return nullptr;
+    }
+
+    const auto it = std::upper_bound(this->entries.begin(), this->entries.end(), turn, [](uint32_t t, const auto &entry) { return t < entry.turn; });
+    return (it == this->entries.begin()) ? &*it : &*std::prev(it);
+}
+
+/*!
+ * @brief 録画ファイルの末尾に書く索引フレームとフッタを作る
+ * @param offset 索引フレームを書く位置 (それまでに書いたバイト数)
+ * @return 索引フレームとフッタ
+ */
+std::string TermDeltaIndex::encode_trailer(uint64_t offset) const
+{
+    std::string ops;
+    append_varint(ops, this->entries.size());
+    TermDeltaIndexEntry previous;
+    for (const auto &entry : this->entries) {
+        append_varint(ops, entry.time - previous.time);
+        append_varint(ops, entry.turn);
+        append_varint(ops, entry.offset - previous.offset);
+        previous = entry;
+    }
+
+    auto trailer = make_frame(TermDeltaFrameType::INDEX, this->end_time, ops);
+    for (auto i = 0; i < 8; i++) {
+        trailer.push_back(static_cast<char>((offset >> (8 * i)) & 0xff));
+    }
+
+    trailer.append(TERM_DELTA_INDEX_MAGIC);
+    return trailer;
+}
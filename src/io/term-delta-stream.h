@@ -0,0 +1,172 @@
+#pragma once
+/*!
+ * @file term-delta-stream.h
+ * @brief 端末の画面の差分をバイナリで符号化・復号する
+ * @details
+ * ストリームは TERM_DELTA_STREAM_HEADER に続けてフレームを並べたもの.
+ * フレームは種別1バイト、本体の長さ (varint)、本体からなり、本体はタイムスタンプ (varint, 100ms単位) と命令の列からなる.
+ * 差分フレームは直前のフレームまでの画面からの差分を、キーフレームは画面全体を表すので、途中から受け取る側はキーフレームから読み始めればよい.
+ * 文字列の位置は、直前の命令が書いた末尾からの (y * 幅 + x) の差を varint で表す.
+ *
+ * 録画ファイルは一定の間隔でキーフレームを挟み、録画を終えるときに末尾へキーフレームの索引フレームと、
+ * 索引フレームの位置 (8バイト, リトルエンディアン) と TERM_DELTA_INDEX_MAGIC からなるフッタを書く.
+ * 再生する側はフッタから索引を読み、目的の時刻の直前のキーフレームから再生を始められる.
+ */
+
+#include "system/h-type.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * @brief ストリームの先頭に置くマジックナンバーとバージョン
+ */
+constexpr std::string_view TERM_DELTA_STREAM_HEADER("HBMV\x01", 5);
+
+/*!
+ * @brief 録画ファイルの末尾のフッタに置くマジックナンバー
+ */
+constexpr std::string_view TERM_DELTA_INDEX_MAGIC = "HBMI";
+
+/*!
+ * @brief フレームの種別
+ */
+enum class TermDeltaFrameType : char {
+    DELTA = 'D', //!< 直前のフレームからの差分
+    KEY = 'K', //!< 画面全体
+    INDEX = 'I', //!< キーフレームの索引 (録画ファイルの末尾にだけ置く)
+};
+
+/*!
+ * @brief フレーム内の命令の種別
+ */
+enum class TermDeltaOpType : uint8_t {
+    SIZE = 1, //!< 画面の大きさ (幅, 高さ)
+    CLEAR = 2, //!< 画面全体の消去
+    TEXT = 3, //!< 同じ属性の文字列 (位置, 長さ, 属性, 文字列)
+    REPEAT = 4, //!< 同じ属性の同じ文字の繰り返し (位置, 長さ, 属性, 文字)
+    WIPE = 5, //!< 空白 (位置, 長さ)
+    CURSOR = 6, //!< カーソルの位置 (x, y, 大きいカーソルか)
+    SHAPE = 7, //!< カーソルの表示状態
+    TURN = 8, //!< キーフレームを作ったときのゲームターン (キーフレームの最初の命令)
+};
+
+/*!
+ * @brief 復号した命令
+ */
+struct TermDeltaOp {
+    TermDeltaOpType type{};
+    TERM_LEN x = 0; //!< 桁 (SIZE では幅)
+    TERM_LEN y = 0; //!< 行 (SIZE では高さ)
+    int n = 0; //!< 文字数 (CURSOR では大きいカーソルか、SHAPE では表示状態、TURN ではゲームターン)
+    TERM_COLOR attr = 0; //!< 属性
+    std::string_view text; //!< TEXT では文字列、REPEAT では繰り返す1文字
+};
+
+/*!
+ * @brief 復号したフレーム
+ */
+struct TermDeltaFrame {
+    TermDeltaFrameType type{};
+    uint32_t time = 0; //!< タイムスタンプ (100ms単位)
+    std::string_view ops; //!< 命令の列
+};
+
+/*!
+ * @brief 描画フックに渡された内容を画面の写しに溜め、フレーム毎に差分を符号化する
+ */
+class TermDeltaEncoder {
+public:
+    TermDeltaEncoder() = default;
+
+    TERM_LEN get_width() const;
+    TERM_LEN get_height() const;
+    void resize(TERM_LEN w, TERM_LEN h);
+    void put_text(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, const char *s);
+    void wipe(TERM_LEN x, TERM_LEN y, int n);
+    void clear();
+    void move_cursor(TERM_LEN x, TERM_LEN y, bool is_big);
+    void set_cursor_shape(int shape);
+    std::string encode_delta(uint32_t time);
+    std::string encode_keyframe(uint32_t time, uint32_t turn) const;
+
+private:
+    struct Cell {
+        TERM_COLOR a = 0;
+        char c = ' ';
+
+        bool operator==(const Cell &other) const = default;
+    };
+
+    TERM_LEN width = 0;
+    TERM_LEN height = 0;
+    std::vector<Cell> current; //!< 描画フックに渡された最新の画面
+    std::vector<Cell> sent; //!< 最後に符号化した画面
+    std::vector<std::pair<TERM_LEN, TERM_LEN>> dirty_ranges; //!< 行毎に書き換えられた桁の範囲 [x1, x2)
+    bool is_resized = false;
+    bool is_cleared = false;
+    bool is_cursor_moved = false;
+    TERM_LEN cursor_x = 0;
+    TERM_LEN cursor_y = 0;
+    bool is_big_cursor = false;
+    bool has_cursor = false;
+    int cursor_shape = 0;
+    int sent_cursor_shape = 0;
+
+    void mark_dirty(TERM_LEN x, TERM_LEN y, int n);
+    void encode_row(std::string &ops, uint32_t &position, TERM_LEN y, const Cell *row, const Cell *base, TERM_LEN x1, TERM_LEN x2) const;
+    void encode_cells(std::string &ops, uint32_t &position, TERM_LEN y, const Cell *row, TERM_LEN x1, TERM_LEN x2) const;
+};
+
+/*!
+ * @brief ストリームからフレームを切り出し、命令を復号する
+ */
+class TermDeltaDecoder {
+public:
+    TermDeltaDecoder() = default;
+
+    static std::optional<TermDeltaFrame> read_frame(std::string_view buffer, size_t &frame_size);
+    void start_frame(std::string_view ops);
+    std::optional<TermDeltaOp> next_op();
+
+private:
+    TERM_LEN width = 0; //!< 最後に受け取った SIZE の幅
+    TERM_LEN height = 0; //!< 最後に受け取った SIZE の高さ
+    std::string_view rest; //!< まだ復号していない命令
+    uint32_t position = 0; //!< 直前の命令が書いた末尾の位置
+};
+
+/*!
+ * @brief 録画ファイルのキーフレームの索引の1項目
+ */
+struct TermDeltaIndexEntry {
+    uint32_t time = 0; //!< タイムスタンプ (100ms単位)
+    uint32_t turn = 0; //!< キーフレームを書いたときのゲームターン
+    uint64_t offset = 0; //!< ファイルの先頭からキーフレームまでのバイト数
+};
+
+/*!
+ * @brief 録画ファイルのキーフレームの索引
+ */
+class TermDeltaIndex {
+public:
+    static constexpr size_t FOOTER_SIZE = 8 + TERM_DELTA_INDEX_MAGIC.size();
+
+    TermDeltaIndex() = default;
+
+    static std::optional<uint64_t> read_footer(std::string_view footer);
+    static TermDeltaIndex decode(const TermDeltaFrame &frame);
+    void add(const TermDeltaIndexEntry &entry);
+    bool empty() const;
+    uint32_t get_end_time() const;
+    void set_end_time(uint32_t time);
+    const TermDeltaIndexEntry *find_by_time(uint32_t time) const;
+    const TermDeltaIndexEntry *find_by_turn(uint32_t turn) const;
+    std::string encode_trailer(uint64_t offset) const;
+
+private:
+    std::vector<TermDeltaIndexEntry> entries;
+    uint32_t end_time = 0; //!< 最後のフレームのタイムスタンプ
+};
@@ -8,16 +8,23 @@
 #include "object/tval-types.h"
 #include "system/angband-system.h"
 #include "system/baseitem-info.h"
+#include "system/rng-stream-guard.h"
+
+/*!
+ * @brief フレーバーのシードに基づいて未鑑定名をシャッフルする
+ * @param baseitems ベースアイテムの一覧
+ */
+static void shuffle_flavors_by_seed(BaseitemList &baseitems)
+{
+    const RngStreamGuard rng_guard(Xoshiro128StarStar(AngbandSystem::get_instance().get_seed_flavor()));
+    baseitems.shuffle_flavors();
+}
 
 /*!
  * @brief ゲーム開始時に行われるベースアイテムの初期化ルーチン
  */
 void initialize_items_flavor()
 {
-    auto &system = AngbandSystem::get_instance();
-    const Xoshiro128StarStar rng_backup = system.get_rng();
-    Xoshiro128StarStar flavor_rng(system.get_seed_flavor());
-    system.set_rng(flavor_rng);
     auto &baseitems = BaseitemList::get_instance();
     for (auto &baseitem : baseitems) {
         if (baseitem.flavor_name.empty()) {
@@ -27,8 +34,7 @@ void initialize_items_flavor()
         baseitem.flavor = baseitem.idx;
     }
 
-    baseitems.shuffle_flavors();
-    system.set_rng(rng_backup);
+    shuffle_flavors_by_seed(baseitems);
     for (auto &baseitem : baseitems) {
         if (!baseitem.is_valid()) {
             continue;
@@ -10,7 +10,7 @@
 #include "core/show-file.h"
 #include "flavor/flavor-describer.h"
 #include "floor/floor-town.h"
-#include "info-reader/fixed-map-parser.h"
+#include "floor/wild.h"
 #include "io-dump/dump-util.h"
 #include "player-info/alignment.h"
 #include "player-info/class-info.h"
@@ -187,8 +187,7 @@ void do_cmd_knowledge_stat(PlayerType *player_ptr)
  */
 void do_cmd_knowledge_home(PlayerType *player_ptr)
 {
-    const auto &world = AngbandWorld::get_instance();
-    parse_fixed_map(player_ptr, WILDERNESS_DEFINITION, 0, 0, world.max_wild_y, world.max_wild_x);
+    parse_wilderness_definition(player_ptr);
 
     FILE *fff = nullptr;
     GAME_TEXT file_name[FILE_NAME_SIZE];
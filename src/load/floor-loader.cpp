@@ -267,6 +267,8 @@ bool load_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode
 #endif
 
     FILE *old_fff = nullptr;
+    std::optional<std::vector<byte>> old_savedata;
+    size_t old_savedata_pos = 0;
     byte old_xor_byte = 0;
     uint32_t old_v_check = 0;
     uint32_t old_x_check = 0;
@@ -275,6 +277,8 @@ bool load_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode
     auto &system = AngbandSystem::get_instance();
     if (mode & SLF_SECOND) {
         old_fff = loading_savefile;
+        old_savedata = std::move(loading_savedata);
+        old_savedata_pos = loading_savedata_pos;
         old_xor_byte = load_xor_byte;
         old_v_check = v_check;
         old_x_check = x_check;
@@ -296,7 +300,7 @@ bool load_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode
     }
 
     if (is_save_successful) {
-        is_save_successful = load_floor_aux(player_ptr, sf_ptr);
+        is_save_successful = prepare_loading_savefile() && load_floor_aux(player_ptr, sf_ptr);
         if (ferror(loading_savefile)) {
             is_save_successful = false;
         }
@@ -312,11 +316,15 @@ bool load_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode
 
     if (mode & SLF_SECOND) {
         loading_savefile = old_fff;
+        loading_savedata = std::move(old_savedata);
+        loading_savedata_pos = old_savedata_pos;
         load_xor_byte = old_xor_byte;
         v_check = old_v_check;
         x_check = old_x_check;
         system.set_version(version_backup);
         loading_savefile_version = old_loading_savefile_version;
+    } else {
+        loading_savedata = std::nullopt;
     }
 
     return is_save_successful;
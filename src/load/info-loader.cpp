@@ -10,6 +10,7 @@
 #include "util/enum-converter.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
 
 /*!
  * @brief セーブファイルからバージョン情報及びセーブ情報を取得する
@@ -74,6 +75,7 @@ void rd_version_info(void)
 
 /*!
  * @brief 乱数状態を読み込む / Read RNG state (added in 2.8.0)
+ * @details 用途毎の乱数列が書き込まれていない (全て0の) セーブデータでは、ゲームの乱数から導出し直す.
  */
 void rd_randomizer(void)
 {
@@ -83,10 +85,28 @@ void rd_randomizer(void)
         s = rd_u32b();
     }
 
+    auto &system = AngbandSystem::get_instance();
     Xoshiro128StarStar game_rng;
     game_rng.set_state(state);
-    AngbandSystem::get_instance().set_rng(game_rng);
-    strip_bytes(4 * (RAND_DEG - state.size()));
+    system.set_rng(game_rng);
+    auto read = static_cast<int>(state.size());
+    auto has_rng_streams = true;
+    for (auto stream = 0; stream < enum2i(RngStream::MAX); stream++) {
+        Xoshiro128StarStar::state_type stream_state{};
+        for (auto &s : stream_state) {
+            s = rd_u32b();
+            read++;
+        }
+
+        has_rng_streams &= std::any_of(stream_state.begin(), stream_state.end(), [](auto s) { return s != 0; });
+        system.get_rng_stream(i2enum<RngStream>(stream)).set_state(stream_state);
+    }
+
+    if (!has_rng_streams) {
+        system.derive_rng_streams();
+    }
+
+    strip_bytes(4 * (RAND_DEG - read));
 }
 
 /*!
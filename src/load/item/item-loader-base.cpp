@@ -13,9 +13,14 @@
 void ItemLoaderBase::load_item()
 {
     auto loading_max_k_idx = rd_u16b();
+    const auto section_records = rd_section_records();
     BaseitemInfo dummy;
     auto &baseitems = BaseitemList::get_instance();
     for (uint16_t i = 0; i < loading_max_k_idx; i++) {
+        if ((section_records > 0) && (i % section_records == 0)) {
+            rd_section_header();
+        }
+
         auto &baseitem = i < baseitems.size() ? baseitems.get_baseitem(i) : dummy;
         const auto tmp8u = rd_byte();
         baseitem.aware = any_bits(tmp8u, 0x01);
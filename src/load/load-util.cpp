@@ -1,10 +1,15 @@
 #include "load/load-util.h"
 #include "locale/character-encoding.h"
 #include "locale/japanese.h"
+#include "system/angband-version.h"
 #include "term/gameterm.h"
 #include "term/screen-processor.h"
+#include "util/lz-compressor.h"
+#include <array>
 
 FILE *loading_savefile;
+std::optional<std::vector<byte>> loading_savedata; // 圧縮コンテナから展開したエンコード済みデータ.
+size_t loading_savedata_pos = 0;
 uint32_t loading_savefile_version;
 byte load_xor_byte; // Old "encryption" byte.
 uint32_t v_check = 0L; // Simple "checksum" on the actual values.
@@ -32,6 +37,123 @@ void load_note(std::string_view msg)
     term_fresh();
 }
 
+/*!
+ * @brief ファイル先頭のバイト列が圧縮コンテナ形式の識別子か否かを返す
+ * @param header ファイル先頭のバイト列
+ * @return 圧縮コンテナ形式ならtrue
+ */
+bool is_savefile_container(std::string_view header)
+{
+    return header.starts_with(SAVEFILE_CONTAINER_MAGIC);
+}
+
+/*!
+ * @brief ファイルから符号なし32bit値をリトルエンディアンで直接読み込む
+ * @param fff ファイルポインタ
+ * @return 読み込んだ値。ファイルが途切れていればstd::nullopt
+ */
+static std::optional<uint32_t> get_u32b_raw(FILE *fff)
+{
+    uint32_t val = 0;
+    for (auto i = 0; i < 4; i++) {
+        const auto c = getc(fff);
+        if (c == EOF) {
+            return std::nullopt;
+        }
+
+        val |= static_cast<uint32_t>(c) << (i * 8);
+    }
+
+    return val;
+}
+
+/*!
+ * @brief ファイルの現在位置から末尾までのバイト数を返す
+ * @param fff ファイルポインタ
+ * @return 残りのバイト数。取得できなければstd::nullopt
+ */
+static std::optional<size_t> get_remaining_size(FILE *fff)
+{
+    const auto pos = ftell(fff);
+    if ((pos < 0) || (fseek(fff, 0, SEEK_END) != 0)) {
+        return std::nullopt;
+    }
+
+    const auto end = ftell(fff);
+    if ((end < pos) || (fseek(fff, pos, SEEK_SET) != 0)) {
+        return std::nullopt;
+    }
+
+    return static_cast<size_t>(end - pos);
+}
+
+/*!
+ * @brief 圧縮コンテナ形式のセーブファイルを展開する
+ * @param fff 先頭位置にあるファイルポインタ
+ * @return 展開したエンコード済みのバイト列。コンテナが壊れているか未対応のバージョンならstd::nullopt
+ */
+std::optional<std::vector<byte>> read_savefile_container(FILE *fff)
+{
+    std::array<char, SAVEFILE_CONTAINER_MAGIC.length()> magic{};
+    if (fread(magic.data(), 1, magic.size(), fff) != magic.size()) {
+        return std::nullopt;
+    }
+
+    if (!is_savefile_container({ magic.data(), magic.size() }) || (getc(fff) != SAVEFILE_CONTAINER_VERSION)) {
+        return std::nullopt;
+    }
+
+    const auto decompressed_size = get_u32b_raw(fff);
+    const auto compressed_size = get_u32b_raw(fff);
+    if (!decompressed_size || !compressed_size) {
+        return std::nullopt;
+    }
+
+    // 壊れたファイルに書かれたサイズのまま巨大な領域を確保しないよう、先にファイルの実際の大きさと比べる
+    const auto remaining_size = get_remaining_size(fff);
+    if (!remaining_size || (*compressed_size > *remaining_size) || (*decompressed_size > util::lz_max_decompressed_size(*compressed_size))) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> compressed(*compressed_size);
+    if (fread(compressed.data(), 1, compressed.size(), fff) != compressed.size()) {
+        return std::nullopt;
+    }
+
+    auto savedata = util::lz_decompress(compressed, *decompressed_size);
+    if (!savedata) {
+        return std::nullopt;
+    }
+
+    // 書き込み時に外したXORを掛け直し、非圧縮時と同じエンコード済みのバイト列に戻す
+    byte prev = 0;
+    for (auto &c : *savedata) {
+        c ^= prev;
+        prev = c;
+    }
+
+    return savedata;
+}
+
+/*!
+ * @brief 読み込み中のファイルが圧縮コンテナ形式なら展開し、以降の読み込みを展開済みのデータから行う
+ * @return 読み込みを続けられるならtrue、コンテナが壊れていればfalse
+ */
+bool prepare_loading_savefile()
+{
+    loading_savedata = std::nullopt;
+    loading_savedata_pos = 0;
+    std::array<char, SAVEFILE_CONTAINER_MAGIC.length()> magic{};
+    const auto read_size = fread(magic.data(), 1, magic.size(), loading_savefile);
+    rewind(loading_savefile);
+    if (!is_savefile_container({ magic.data(), read_size })) {
+        return true;
+    }
+
+    loading_savedata = read_savefile_container(loading_savefile);
+    return loading_savedata.has_value();
+}
+
 /*!
  * @brief ロードファイルポインタから1バイトを読み込む
  * @return 読み込んだバイト値
@@ -41,7 +163,14 @@ void load_note(std::string_view msg)
  */
 byte sf_get(void)
 {
-    byte c = getc(loading_savefile) & 0xFF;
+    byte c;
+    if (loading_savedata) {
+        const auto &savedata = *loading_savedata;
+        c = (loading_savedata_pos < savedata.size()) ? savedata[loading_savedata_pos++] : 0xFF;
+    } else {
+        c = getc(loading_savefile) & 0xFF;
+    }
+
     byte v = c ^ load_xor_byte;
     load_xor_byte = c;
 
@@ -167,6 +296,29 @@ void strip_bytes(int n)
     }
 }
 
+/*!
+ * @brief 区画に分けて書き込まれたレコード群の、1区画あたりのレコード数を読み込む
+ * @return 1区画あたりのレコード数。区画に分かれていない古いセーブファイルなら0
+ */
+uint16_t rd_section_records()
+{
+    if (loading_savefile_version_is_older_than(24)) {
+        return 0;
+    }
+
+    return rd_u16b();
+}
+
+/*!
+ * @brief 区画の先頭を読み込む
+ * @details 区画のバイト数を読み飛ばし、区画毎にリセットされるXORバイトを0に戻す.
+ */
+void rd_section_header()
+{
+    strip_bytes(4);
+    load_xor_byte = 0;
+}
+
 /**
  * @brief ロード中のセーブファイルのバージョンが引数で指定したバージョンと比較して古いかどうか調べる
  *
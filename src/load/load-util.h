@@ -4,12 +4,16 @@
 
 #include <algorithm>
 #include <bitset>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 enum class CharacterEncoding : uint8_t;
 
 extern FILE *loading_savefile;
+extern std::optional<std::vector<byte>> loading_savedata;
+extern size_t loading_savedata_pos;
 extern uint32_t loading_savefile_version;
 extern byte load_xor_byte;
 extern uint32_t v_check;
@@ -17,6 +21,9 @@ extern uint32_t x_check;
 extern CharacterEncoding loading_character_encoding;
 
 void load_note(std::string_view msg);
+bool is_savefile_container(std::string_view header);
+std::optional<std::vector<byte>> read_savefile_container(FILE *fff);
+bool prepare_loading_savefile();
 byte sf_get();
 bool rd_bool();
 byte rd_byte();
@@ -26,6 +33,8 @@ uint32_t rd_u32b();
 int32_t rd_s32b();
 std::string rd_string();
 void strip_bytes(int n);
+uint16_t rd_section_records();
+void rd_section_header();
 bool loading_savefile_version_is_older_than(uint32_t version);
 
 /**
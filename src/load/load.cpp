@@ -47,8 +47,11 @@
 #include "system/system-variables.h"
 #include "util/angband-files.h"
 #include "util/enum-converter.h"
+#include "util/finalizer.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -270,28 +273,42 @@ static errr exe_reading_savefile(PlayerType *player_ptr)
 /*!
  * @brief セーブファイル読み込み処理 (UIDチェック等含む) / Reading the savefile (including UID check)
  * @param player_ptr プレイヤーへの参照ポインタ
+ * @param savedata 圧縮コンテナから展開済みのエンコード済みデータ。非圧縮のセーブファイルならstd::nullopt
  * @return エラーコード
+ * @details 圧縮コンテナは load_savedata() でバージョン情報を読む際に展開済みなので、ファイルを開き直さずそのまま読み込む.
  */
-static errr rd_savefile(PlayerType *player_ptr)
+static errr rd_savefile(PlayerType *player_ptr, std::optional<std::vector<byte>> &&savedata)
 {
-    safe_setuid_grab();
-    loading_savefile = angband_fopen(savefile, FileOpenMode::READ, true);
-    safe_setuid_drop();
-    if (!loading_savefile) {
-        return -1;
+    loading_savefile = nullptr;
+    loading_savedata = std::move(savedata);
+    loading_savedata_pos = 0;
+    if (!loading_savedata) {
+        safe_setuid_grab();
+        loading_savefile = angband_fopen(savefile, FileOpenMode::READ, true);
+        safe_setuid_drop();
+        if (!loading_savefile) {
+            return -1;
+        }
     }
 
+    const auto finalizer = util::make_finalizer([]() {
+        if (loading_savefile) {
+            angband_fclose(loading_savefile);
+            loading_savefile = nullptr;
+        }
+
+        loading_savedata = std::nullopt;
+    });
+
     try {
         auto err = exe_reading_savefile(player_ptr);
-        if (ferror(loading_savefile)) {
+        if (loading_savefile && ferror(loading_savefile)) {
             err = -1;
         }
 
-        angband_fclose(loading_savefile);
         return err;
     } catch (SaveDataNotSupportedException const &e) {
         msg_print(e.what());
-        angband_fclose(loading_savefile);
         return 1;
     }
 }
@@ -374,6 +391,7 @@ bool load_savedata(PlayerType *player_ptr, bool *new_game)
     constexpr auto variant_length = static_cast<char>(VARIANT_NAME.length());
     constexpr auto version_length = variant_length + 6;
     char tmp_ver[version_length]{};
+    std::optional<std::vector<byte>> savedata;
     if (!err) {
         fd = fd_open(savefile, O_RDONLY);
         if (fd < 0) {
@@ -395,6 +413,24 @@ bool load_savedata(PlayerType *player_ptr, bool *new_game)
         }
     }
 
+    if (!err && is_savefile_container({ tmp_ver, static_cast<size_t>(version_length) })) {
+        safe_setuid_grab();
+        auto *fff = angband_fopen(savefile, FileOpenMode::READ, true);
+        safe_setuid_drop();
+        savedata = fff ? read_savefile_container(fff) : std::nullopt;
+        if (fff) {
+            angband_fclose(fff);
+        }
+
+        if (savedata && (savedata->size() >= static_cast<size_t>(version_length))) {
+            std::copy_n(savedata->begin(), version_length, tmp_ver);
+        } else {
+            (void)fd_close(fd);
+            err = true;
+            what = _("圧縮されたセーブファイルを展開できません", "Cannot decompress savefile");
+        }
+    }
+
     if (!err) {
         // v0.0.X～v3.0.0 Alpha51までは、セーブデータの第1バイトがFAKE_MAJOR_VERというZangbandと互換性を取ったバージョン番号フィールドだった.
         // v3.0.0 Alpha52以降は、バリアント名の長さフィールドとして再定義した.
@@ -426,7 +462,7 @@ bool load_savedata(PlayerType *player_ptr, bool *new_game)
 
     if (!err) {
         term_clear();
-        auto ret_rd_savefile = rd_savefile(player_ptr);
+        auto ret_rd_savefile = rd_savefile(player_ptr, std::move(savedata));
         if (ret_rd_savefile != 0) {
             err = true;
         }
@@ -414,8 +414,13 @@ static void rd_lore(MonsterRaceInfo *r_ptr, const MonsterRaceId r_idx)
 void load_lore(void)
 {
     auto loading_max_r_idx = rd_u16b();
+    const auto section_records = rd_section_records();
     MonsterRaceInfo dummy;
     for (auto i = 0U; i < loading_max_r_idx; i++) {
+        if ((section_records > 0) && (i % section_records == 0)) {
+            rd_section_header();
+        }
+
         auto r_idx = static_cast<MonsterRaceId>(i);
         auto *r_ptr = i < monraces_info.size() ? &monraces_info[r_idx] : &dummy;
         rd_lore(r_ptr, r_idx);
@@ -221,6 +221,9 @@ struct term_data {
 /* Information about our windows */
 static term_data data[MAX_TERM_DATA];
 
+/* サブウィンドウの更新のうち、まだ端末へ送っていないものがあるか */
+static bool update_pending = false;
+
 /*
  * Hack -- try to guess which systems use what commands
  * Hack -- allow one of the "USE_Txxxxx" flags to be pre-set.
@@ -947,6 +950,38 @@ static errr game_term_xtra_gcu_react(void)
     return 0;
 }
 
+/*
+ * Flush the Curses buffer
+ * サブウィンドウの更新は curses の仮想画面へ反映するだけにしておき、
+ * メインウィンドウの更新時に doupdate() 1回でまとめて端末へ送る
+ */
+static void game_term_fresh_gcu(term_data *td)
+{
+    (void)wnoutrefresh(td->win);
+    if (td != &data[0]) {
+        update_pending = true;
+        return;
+    }
+
+    (void)doupdate();
+    update_pending = false;
+}
+
+/*
+ * 入力を確かめる前に、端末へ送っていないサブウィンドウの更新を送る
+ */
+static void game_term_flush_pending_gcu(void)
+{
+    if (!update_pending) {
+        return;
+    }
+
+    /* カーソルはメインウィンドウに置く */
+    (void)wnoutrefresh(data[0].win);
+    (void)doupdate();
+    update_pending = false;
+}
+
 /*
  * Handle a "special request"
  */
@@ -972,7 +1007,7 @@ static errr game_term_xtra_gcu(int n, int v)
 
     /* Flush the Curses buffer */
     case TERM_XTRA_FRESH:
-        (void)wrefresh(td->win);
+        game_term_fresh_gcu(td);
         return 0;
 
     /* Change the cursor visibility */
@@ -986,6 +1021,7 @@ static errr game_term_xtra_gcu(int n, int v)
 
     /* Process events */
     case TERM_XTRA_EVENT:
+        game_term_flush_pending_gcu();
         return game_term_xtra_gcu_event(v);
 
     /* Flush events */
@@ -997,6 +1033,7 @@ static errr game_term_xtra_gcu(int n, int v)
 
     /* Delay */
     case TERM_XTRA_DELAY:
+        game_term_flush_pending_gcu();
         usleep(1000 * v);
         return 0;
 
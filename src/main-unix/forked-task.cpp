@@ -0,0 +1,173 @@
+/*!
+ * @file forked-task.cpp
+ * @brief fork した子プロセスで処理を行い、結果のバイト列を受け取るタスクの実装
+ * @details
+ * 子プロセスは端末やセーブファイルに触れずに処理を行い、結果をパイプに書いて _exit() する.
+ * 処理が例外を投げたり quit() を呼んだりした場合は失敗として終了コード1で終わる.
+ */
+
+#include "main-unix/forked-task.h"
+#include "term/z-util.h"
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::array<int, 9> DEFAULT_SIGNALS = { SIGFPE, SIGILL, SIGTRAP, SIGABRT, SIGBUS, SIGSEGV, SIGTERM, SIGPIPE, SIGSYS };
+constexpr std::array<int, 4> IGNORED_SIGNALS = { SIGINT, SIGQUIT, SIGTSTP, SIGHUP };
+
+/*!
+ * @brief 子プロセスが親プロセスの端末やセーブファイルに触れないようにする
+ * @details 致命的なシグナルで緊急セーブせず、端末からの割り込みは親プロセスだけが受け取る.
+ */
+void detach_child_process()
+{
+    for (const auto sig : DEFAULT_SIGNALS) {
+        (void)std::signal(sig, SIG_DFL);
+    }
+
+    for (const auto sig : IGNORED_SIGNALS) {
+        (void)std::signal(sig, SIG_IGN);
+    }
+
+    quit_aux = [](concptr) { _exit(EXIT_FAILURE); };
+    plog_aux = [](concptr) {};
+}
+
+bool write_all(int fd, const std::vector<byte> &bytes)
+{
+    size_t written = 0;
+    while (written < bytes.size()) {
+        const auto size = write(fd, bytes.data() + written, bytes.size() - written);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        written += size;
+    }
+
+    return true;
+}
+}
+
+ForkedTask::ForkedTask(pid_t pid, int fd)
+    : pid(pid)
+    , fd(fd)
+{
+}
+
+/*!
+ * @brief 子プロセスが終わっていなければ止めて回収する
+ */
+ForkedTask::~ForkedTask()
+{
+    if (this->fd >= 0) {
+        (void)close(this->fd);
+    }
+
+    if (this->pid > 0) {
+        (void)kill(this->pid, SIGKILL);
+        (void)waitpid(this->pid, nullptr, 0);
+    }
+}
+
+/*!
+ * @brief 子プロセスを fork して処理を始める
+ * @param task 子プロセスで行う処理. 戻り値が親プロセスに渡される
+ * @return タスク. fork できなかった場合はnullptr
+ */
+std::unique_ptr<ForkedTask> ForkedTask::start(const std::function<std::vector<byte>()> &task)
+{
+    std::array<int, 2> fds{};
+    if (pipe(fds.data()) < 0) {
+        return nullptr;
+    }
+
+    const auto pid = fork();
+    if (pid < 0) {
+        (void)close(fds[0]);
+        (void)close(fds[1]);
+        return nullptr;
+    }
+
+    if (pid == 0) {
+        (void)close(fds[0]);
+        detach_child_process();
+        auto is_successful = false;
+        try {
+            is_successful = write_all(fds[1], task());
+        } catch (...) {
+            is_successful = false;
+        }
+
+        _exit(is_successful ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    (void)close(fds[1]);
+    (void)fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    (void)fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    return std::unique_ptr<ForkedTask>(new ForkedTask(pid, fds[0]));
+}
+
+/*!
+ * @brief 待たずに読めるだけ結果を受け取る
+ * @return 結果を最後まで受け取ったか
+ * @details 子プロセスがパイプの容量を超える結果を書けるよう、ゲームの合間に呼び続ける.
+ */
+bool ForkedTask::poll()
+{
+    std::array<byte, 65536> buffer;
+    while (!this->is_finished) {
+        const auto size = read(this->fd, buffer.data(), buffer.size());
+        if (size > 0) {
+            this->result.insert(this->result.end(), buffer.begin(), buffer.begin() + size);
+            continue;
+        }
+
+        if ((size < 0) && (errno == EINTR)) {
+            continue;
+        }
+
+        if ((size < 0) && (errno == EAGAIN)) {
+            return false;
+        }
+
+        this->is_finished = true;
+    }
+
+    return true;
+}
+
+/*!
+ * @brief 子プロセスが終わるまで待って結果を受け取る
+ * @return 結果. 処理に失敗した場合はstd::nullopt
+ */
+std::optional<std::vector<byte>> ForkedTask::wait()
+{
+    (void)fcntl(this->fd, F_SETFL, fcntl(this->fd, F_GETFL) & ~O_NONBLOCK);
+    (void)this->poll();
+    (void)close(this->fd);
+    this->fd = -1;
+    auto status = 0;
+    while (waitpid(this->pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            this->pid = -1;
+            return std::nullopt;
+        }
+    }
+
+    this->pid = -1;
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS)) {
+        return std::nullopt;
+    }
+
+    return std::move(this->result);
+}
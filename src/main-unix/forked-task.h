@@ -0,0 +1,40 @@
+#pragma once
+/*!
+ * @file forked-task.h
+ * @brief fork した子プロセスで処理を行い、結果のバイト列を受け取るタスクのヘッダ
+ */
+
+#include "system/angband.h"
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sys/types.h>
+#include <vector>
+
+/*!
+ * @brief fork した子プロセスで処理を行うタスク
+ * @details
+ * 子プロセスはゲームの状態をコピーオンライトで引き継ぐので、現在の状態を書き換えながら処理を行ってもよい.
+ * 結果はパイプで受け取り、子プロセスが書き換えた状態は捨てられる.
+ * 受け取る前に破棄すると子プロセスを止める.
+ */
+class ForkedTask {
+public:
+    ForkedTask(const ForkedTask &) = delete;
+    ForkedTask(ForkedTask &&) = delete;
+    ForkedTask &operator=(const ForkedTask &) = delete;
+    ForkedTask &operator=(ForkedTask &&) = delete;
+    ~ForkedTask();
+
+    static std::unique_ptr<ForkedTask> start(const std::function<std::vector<byte>()> &task);
+    bool poll();
+    std::optional<std::vector<byte>> wait();
+
+private:
+    ForkedTask(pid_t pid, int fd);
+
+    pid_t pid; //!< 子プロセスのID. 回収済みなら-1
+    int fd; //!< 結果を受け取るパイプ. 閉じていれば-1
+    std::vector<byte> result; //!< 受け取った結果
+    bool is_finished = false; //!< 結果を最後まで受け取ったか
+};
@@ -0,0 +1,225 @@
+/*!
+ * @file spectator-broadcaster.cpp
+ * @brief 画面のストリームを Unix ドメインソケットで観戦者に配信するクラスの実装
+ */
+
+#include "main-unix/spectator-broadcaster.h"
+#include "term/z-form.h"
+#include "term/z-util.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+/*!
+ * @brief 観戦者1人あたりの送信待ちの上限. これを超えたら画面全体を送り直す
+ */
+constexpr size_t MAX_PENDING_SIZE = 1024 * 1024;
+
+/*!
+ * @brief 同時に接続できる観戦者の数
+ */
+constexpr size_t MAX_SPECTATORS = 64;
+
+sockaddr_un make_socket_address(std::string_view socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || (socket_path.size() >= sizeof(address.sun_path))) {
+        quit_fmt("Invalid spectator socket path: %s", std::string(socket_path).data());
+    }
+
+    socket_path.copy(address.sun_path, socket_path.size());
+    return address;
+}
+}
+
+/*!
+ * @brief 観戦者の接続を待ち受けるソケットを作る
+ * @param socket_path 待ち受ける Unix ドメインソケットのパス
+ * @param header 接続してきた観戦者に最初に送るストリームのヘッダ
+ */
+SpectatorBroadcaster::SpectatorBroadcaster(std::string_view socket_path, std::string_view header)
+    : socket_path(socket_path)
+    , header(std::make_shared<const std::string>(header))
+{
+    const auto address = make_socket_address(socket_path);
+    this->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (this->listener < 0) {
+        quit("Cannot create the spectator socket.");
+    }
+
+    (void)unlink(address.sun_path);
+    if ((bind(this->listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0) || (listen(this->listener, SOMAXCONN) < 0)) {
+        quit_fmt("Cannot listen on %s: %s", address.sun_path, std::strerror(errno));
+    }
+
+    (void)fcntl(this->listener, F_SETFL, fcntl(this->listener, F_GETFL) | O_NONBLOCK);
+    (void)fcntl(this->listener, F_SETFD, FD_CLOEXEC);
+}
+
+SpectatorBroadcaster::~SpectatorBroadcaster()
+{
+    for (const auto &spectator : this->spectators) {
+        (void)close(spectator.fd);
+    }
+
+    (void)close(this->listener);
+    (void)unlink(this->socket_path.data());
+}
+
+/*!
+ * @brief 1フレームを全員に配信する
+ * @param frame 直前のフレームからの差分フレーム
+ * @param make_keyframe このフレームまでを反映した画面全体のキーフレームを作る関数 (必要な観戦者がいる場合だけ呼ぶ)
+ */
+void SpectatorBroadcaster::broadcast(std::string_view frame, const KeyframeMaker &make_keyframe)
+{
+    this->accept_spectators();
+    this->send_keyframes(make_keyframe);
+    SharedFrame shared_frame;
+    for (auto &spectator : this->spectators) {
+        if (spectator.needs_keyframe) {
+            continue;
+        }
+
+        if (!shared_frame) {
+            shared_frame = std::make_shared<const std::string>(frame);
+        }
+
+        this->enqueue(spectator, shared_frame);
+    }
+
+    this->send_all();
+}
+
+/*!
+ * @brief 新しいフレームがなくても接続を受け付け、送信待ちを送る
+ * @param make_keyframe 最後に配信したフレームまでを反映した画面全体のキーフレームを作る関数
+ * @details 入力待ちの間にも呼ぶことで、画面が変わらなくても観戦を始められる
+ */
+void SpectatorBroadcaster::poll(const KeyframeMaker &make_keyframe)
+{
+    this->accept_spectators();
+    this->send_keyframes(make_keyframe);
+    this->send_all();
+}
+
+void SpectatorBroadcaster::accept_spectators()
+{
+    while (true) {
+        const auto fd = accept(this->listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return;
+        }
+
+        if (this->spectators.size() >= MAX_SPECTATORS) {
+            (void)close(fd);
+            continue;
+        }
+
+        (void)fcntl(fd, F_SETFD, FD_CLOEXEC);
+        auto &spectator = this->spectators.emplace_back();
+        spectator.fd = fd;
+        this->enqueue(spectator, this->header);
+    }
+}
+
+/*!
+ * @brief 観戦者のキューにフレームを積む
+ * @details キューが溢れる場合は送りかけのフレームだけを残して捨て、次はキーフレームから送り直す
+ */
+void SpectatorBroadcaster::enqueue(Spectator &spectator, const SharedFrame &frame)
+{
+    if (spectator.pending_size + frame->size() <= MAX_PENDING_SIZE) {
+        spectator.frames.push_back(frame);
+        spectator.pending_size += frame->size();
+        return;
+    }
+
+    const auto keep = (spectator.offset > 0) ? 1 : 0;
+    spectator.frames.resize(keep);
+    spectator.pending_size = keep ? spectator.frames.front()->size() - spectator.offset : 0;
+    spectator.needs_keyframe = true;
+}
+
+void SpectatorBroadcaster::send_keyframes(const KeyframeMaker &make_keyframe)
+{
+    SharedFrame keyframe;
+    for (auto &spectator : this->spectators) {
+        if (!spectator.needs_keyframe) {
+            continue;
+        }
+
+        if (!keyframe) {
+            keyframe = std::make_shared<const std::string>(make_keyframe());
+        }
+
+        spectator.needs_keyframe = false;
+        this->enqueue(spectator, keyframe);
+    }
+}
+
+/*!
+ * @brief 観戦者のキューをソケットが受け付けるだけ送る
+ * @return 接続を続けられるか
+ */
+bool SpectatorBroadcaster::send_pending(Spectator &spectator)
+{
+    while (!spectator.frames.empty()) {
+        const auto &frame = *spectator.frames.front();
+        const auto size = send(spectator.fd, frame.data() + spectator.offset, frame.size() - spectator.offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+        }
+
+        spectator.offset += size;
+        spectator.pending_size -= size;
+        if (spectator.offset == frame.size()) {
+            spectator.frames.pop_front();
+            spectator.offset = 0;
+        }
+    }
+
+    return true;
+}
+
+void SpectatorBroadcaster::send_all()
+{
+    for (auto &spectator : this->spectators) {
+        if (!this->send_pending(spectator)) {
+            (void)close(spectator.fd);
+            spectator.fd = -1;
+        }
+    }
+
+    std::erase_if(this->spectators, [](const auto &spectator) { return spectator.fd < 0; });
+}
+
+/*!
+ * @brief 配信しているゲームに観戦者として接続する
+ * @param socket_path 配信しているゲームの Unix ドメインソケットのパス
+ * @return 接続したソケット. ストリームのヘッダから順に読める
+ */
+int connect_spectator_broadcaster(std::string_view socket_path)
+{
+    const auto address = make_socket_address(socket_path);
+    const auto connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((connection < 0) || (connect(connection, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0)) {
+        quit_fmt("Cannot connect to %s: %s", address.sun_path, std::strerror(errno));
+    }
+
+    return connection;
+}
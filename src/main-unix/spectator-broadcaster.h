@@ -0,0 +1,59 @@
+#pragma once
+/*!
+ * @file spectator-broadcaster.h
+ * @brief 画面のストリームを Unix ドメインソケットで観戦者に配信するクラスのヘッダ
+ */
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * @brief 画面のストリームを接続してきた観戦者全員に配信する
+ * @details
+ * 送信は全てノンブロッキングで行い、送り切れなかった分は観戦者毎のキューに溜める.
+ * キューが溢れた観戦者は送りかけのフレームを除いて捨て、次に送るときに画面全体 (キーフレーム) を送り直す.
+ * 遅い観戦者がいてもゲームを待たせない.
+ */
+class SpectatorBroadcaster {
+public:
+    using KeyframeMaker = std::function<std::string_view()>;
+
+    SpectatorBroadcaster(std::string_view socket_path, std::string_view header);
+    ~SpectatorBroadcaster();
+    SpectatorBroadcaster(const SpectatorBroadcaster &) = delete;
+    SpectatorBroadcaster &operator=(const SpectatorBroadcaster &) = delete;
+
+    void broadcast(std::string_view frame, const KeyframeMaker &make_keyframe);
+    void poll(const KeyframeMaker &make_keyframe);
+
+private:
+    using SharedFrame = std::shared_ptr<const std::string>;
+
+    /*!
+     * @brief 観戦者1人分の接続と送信待ちのキュー
+     */
+    struct Spectator {
+        int fd = -1;
+        std::deque<SharedFrame> frames; //!< 送信待ちのフレーム
+        size_t offset = 0; //!< 先頭のフレームのうち送信済みのバイト数
+        size_t pending_size = 0; //!< 送信待ちの合計バイト数
+        bool needs_keyframe = true; //!< 次に送るのはキーフレームか
+    };
+
+    std::string socket_path;
+    SharedFrame header;
+    int listener = -1;
+    std::vector<Spectator> spectators;
+
+    void accept_spectators();
+    void enqueue(Spectator &spectator, const SharedFrame &frame);
+    void send_keyframes(const KeyframeMaker &make_keyframe);
+    bool send_pending(Spectator &spectator);
+    void send_all();
+};
+
+int connect_spectator_broadcaster(std::string_view socket_path);
@@ -0,0 +1,294 @@
+/*!
+ * @file zygote-server.cpp
+ * @brief 初期化を済ませたプロセスからセッション毎に fork するサーバーの実装
+ * @details
+ * 定義ファイルの読み込みなど端末に依存しない初期化を1回だけ済ませたプロセスが Unix ドメインソケットで接続を待ち、
+ * 接続毎に fork した子プロセスでゲームを始める. 子プロセスは読み込み済みのデータを親プロセスとコピーオンライトで共有する.
+ *
+ * クライアントは SCM_RIGHTS で端末のファイル記述子を1つ送り、本文でプレイヤー名と TERM の値をそれぞれ '\0' 終端で送る.
+ * 子プロセスはゲームが終わるまで接続を開いたままにするので、クライアントは接続が閉じられるまで待てばよい.
+ *
+ * セーブファイルはサーバーのユーザーIDで名前を付けるので、ソケットはサーバーのユーザーにだけ読み書きを許し、
+ * 接続してきたプロセスのユーザーIDがサーバーと異なる場合はセッションを始めずに切断する.
+ */
+
+#include "main-unix/zygote-server.h"
+#include "term/z-form.h"
+#include "term/z-util.h"
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <optional>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t MAX_SESSION_REQUEST_SIZE = 256;
+
+/*!
+ * @brief ファイル記述子を1つ載せる制御メッセージのバッファ
+ */
+union FdControlBuffer {
+    cmsghdr header;
+    std::array<char, CMSG_SPACE(sizeof(int))> data;
+};
+
+sockaddr_un make_socket_address(std::string_view socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || (socket_path.size() >= sizeof(address.sun_path))) {
+        quit_fmt("Invalid zygote socket path: %s", std::string(socket_path).data());
+    }
+
+    socket_path.copy(address.sun_path, socket_path.size());
+    return address;
+}
+
+/*!
+ * @brief 前回のサーバーが残したソケットを消す
+ * @param address 待ち受ける Unix ドメインソケットのアドレス
+ * @details ソケット以外のファイル・他のユーザーのソケット・まだ待ち受けているソケットは消さずに終了する
+ */
+void remove_stale_socket(const sockaddr_un &address)
+{
+    struct stat st;
+    if (lstat(address.sun_path, &st) != 0) {
+        if (errno == ENOENT) {
+            return;
+        }
+
+        quit_fmt("Cannot stat %s: %s", address.sun_path, std::strerror(errno));
+    }
+
+    if (!S_ISSOCK(st.st_mode) || (st.st_uid != getuid())) {
+        quit_fmt("%s exists and is not a socket of this user.", address.sun_path);
+    }
+
+    const auto probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    const auto is_listening = (probe >= 0) && (connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0);
+    if (probe >= 0) {
+        (void)close(probe);
+    }
+
+    if (is_listening) {
+        quit_fmt("Another server is listening on %s.", address.sun_path);
+    }
+
+    (void)unlink(address.sun_path);
+}
+
+/*!
+ * @brief サーバーのユーザーにだけ読み書きを許すソケットを作り、接続を待ち受ける
+ * @param address 待ち受ける Unix ドメインソケットのアドレス
+ * @return 待ち受けるソケット
+ * @details ソケットのファイルを作るときから umask で他のユーザーの権限を外し、作った後にも念のため 0600 にする
+ */
+int listen_private_socket(const sockaddr_un &address)
+{
+    const auto listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        quit("Cannot create the zygote socket.");
+    }
+
+    remove_stale_socket(address);
+    const auto old_mask = umask(077);
+    const auto is_bound = bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+    (void)umask(old_mask);
+    if (!is_bound || (chmod(address.sun_path, S_IRUSR | S_IWUSR) < 0) || (listen(listener, SOMAXCONN) < 0)) {
+        quit_fmt("Cannot listen on %s: %s", address.sun_path, std::strerror(errno));
+    }
+
+    return listener;
+}
+
+/*!
+ * @brief 接続してきたプロセスのユーザーIDを得る
+ * @param connection 接続
+ * @return ユーザーID. 得られなかった場合はstd::nullopt
+ */
+std::optional<uid_t> get_peer_user_id(int connection)
+{
+#ifdef SO_PEERCRED
+    ucred credential{};
+    socklen_t size = sizeof(credential);
+    if (getsockopt(connection, SOL_SOCKET, SO_PEERCRED, &credential, &size) != 0) {
+        return std::nullopt;
+    }
+
+    return credential.uid;
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(connection, &uid, &gid) != 0) {
+        return std::nullopt;
+    }
+
+    return uid;
+#endif
+}
+
+/*!
+ * @brief 接続から端末のファイル記述子とセッションの情報を受け取る
+ * @param connection 接続
+ * @param session 受け取ったセッションの情報を格納する
+ * @return 端末のファイル記述子. 受け取れなかった場合は-1
+ */
+int receive_session(int connection, ZygoteSession &session)
+{
+    std::array<char, MAX_SESSION_REQUEST_SIZE> body{};
+    iovec iov{ body.data(), body.size() };
+    FdControlBuffer control{};
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data.data();
+    message.msg_controllen = control.data.size();
+    const auto size = recvmsg(connection, &message, 0);
+    if (size <= 0) {
+        return -1;
+    }
+
+    const auto *cmsg = CMSG_FIRSTHDR(&message);
+    if ((cmsg == nullptr) || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS) || (cmsg->cmsg_len != CMSG_LEN(sizeof(int)))) {
+        return -1;
+    }
+
+    int terminal;
+    std::memcpy(&terminal, CMSG_DATA(cmsg), sizeof(terminal));
+    const std::string_view fields(body.data(), size);
+    const auto name_end = fields.find('\0');
+    session.player_name = fields.substr(0, name_end);
+    if (name_end != std::string_view::npos) {
+        const auto term_name = fields.substr(name_end + 1);
+        session.term_name = term_name.substr(0, term_name.find('\0'));
+    }
+
+    return terminal;
+}
+
+/*!
+ * @brief 受け取った端末を子プロセスの標準入出力にする
+ * @details クライアントの端末は既にクライアント側のセッションの制御端末なので、制御端末にできなくてもそのまま続ける.
+ */
+void attach_terminal(int terminal)
+{
+    (void)setsid();
+    (void)ioctl(terminal, TIOCSCTTY, 0);
+    for (auto fd = STDIN_FILENO; fd <= STDERR_FILENO; fd++) {
+        (void)dup2(terminal, fd);
+    }
+
+    if (terminal > STDERR_FILENO) {
+        (void)close(terminal);
+    }
+}
+}
+
+/*!
+ * @brief 接続を待ち、接続毎に fork して子プロセスでセッションを始める
+ * @param socket_path 待ち受ける Unix ドメインソケットのパス
+ * @return 子プロセスが受け取ったセッションの情報 (親プロセスは戻らない)
+ */
+ZygoteSession run_zygote_server(std::string_view socket_path)
+{
+    const auto address = make_socket_address(socket_path);
+    const auto listener = listen_private_socket(address);
+
+    /* 終了した子プロセスを待たずに回収させる */
+    (void)std::signal(SIGCHLD, SIG_IGN);
+    while (true) {
+        const auto connection = accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            quit_fmt("Cannot accept a session: %s", std::strerror(errno));
+        }
+
+        if (get_peer_user_id(connection) != getuid()) {
+            (void)close(connection);
+            continue;
+        }
+
+        ZygoteSession session;
+        const auto terminal = receive_session(connection, session);
+        if ((terminal < 0) || session.player_name.empty() || (fork() != 0)) {
+            if (terminal >= 0) {
+                (void)close(terminal);
+            }
+
+            (void)close(connection);
+            continue;
+        }
+
+        (void)close(listener);
+        (void)std::signal(SIGCHLD, SIG_DFL);
+        (void)fcntl(connection, F_SETFD, FD_CLOEXEC);
+        attach_terminal(terminal);
+        return session;
+    }
+}
+
+/*!
+ * @brief サーバーにこの端末でのセッションを依頼し、セッションが終わるまで待つ
+ * @param socket_path サーバーの Unix ドメインソケットのパス
+ * @param player_name プレイヤー名
+ */
+void connect_zygote_server(std::string_view socket_path, std::string_view player_name)
+{
+    const auto address = make_socket_address(socket_path);
+    const auto connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((connection < 0) || (connect(connection, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0)) {
+        quit_fmt("Cannot connect to %s: %s", address.sun_path, std::strerror(errno));
+    }
+
+    const auto *term_name = std::getenv("TERM");
+    std::string body(player_name);
+    body.push_back('\0');
+    body.append(term_name ? term_name : "");
+    body.push_back('\0');
+    if (body.size() > MAX_SESSION_REQUEST_SIZE) {
+        quit("Player name is too long.");
+    }
+
+    iovec iov{ body.data(), body.size() };
+    FdControlBuffer control{};
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data.data();
+    message.msg_controllen = control.data.size();
+    auto *cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    const int terminal = STDIN_FILENO;
+    std::memcpy(CMSG_DATA(cmsg), &terminal, sizeof(terminal));
+    if (sendmsg(connection, &message, 0) < 0) {
+        quit_fmt("Cannot start a session: %s", std::strerror(errno));
+    }
+
+    /* 端末はセッション側が使うので、こちらは割り込みを無視して接続が閉じられるのを待つ */
+    (void)std::signal(SIGINT, SIG_IGN);
+    (void)std::signal(SIGQUIT, SIG_IGN);
+    (void)std::signal(SIGTSTP, SIG_IGN);
+    char c;
+    while (true) {
+        const auto size = read(connection, &c, 1);
+        if ((size > 0) || ((size < 0) && (errno == EINTR))) {
+            continue;
+        }
+
+        break;
+    }
+
+    (void)close(connection);
+}
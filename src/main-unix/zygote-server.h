@@ -0,0 +1,19 @@
+#pragma once
+/*!
+ * @file zygote-server.h
+ * @brief 初期化を済ませたプロセスからセッション毎に fork するサーバーのヘッダ
+ */
+
+#include <string>
+#include <string_view>
+
+/*!
+ * @brief fork した子プロセスが受け取ったセッションの情報
+ */
+struct ZygoteSession {
+    std::string player_name; //!< プレイヤー名
+    std::string term_name; //!< 端末の種類 (TERM 環境変数の値)
+};
+
+ZygoteSession run_zygote_server(std::string_view socket_path);
+void connect_zygote_server(std::string_view socket_path, std::string_view player_name);
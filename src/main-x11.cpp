@@ -111,6 +111,7 @@
 #include <memory>
 #include <span>
 #include <string>
+#include <vector>
 
 /*
  * Available graphic modes
@@ -237,11 +238,15 @@ struct metadpy {
  * I assume that the root windw is also at most 30000 square.
  *
  *	- The Window
+ *	- The off-screen Pixmap everything is drawn to
+ *	- The GC used to clear the Pixmap and copy it to the Window
+ *	- The background Pixell of the Window
  *	- The current Input Event Mask
  *
  *	- The location of the window
  *	- The width, height of the window
  *	- The border width of this window
+ *	- The part of the Pixmap not yet copied to the Window
  *
  *	- Byte: 1st Extra byte
  *
@@ -258,6 +263,9 @@ struct metadpy {
  */
 struct infowin {
     Window win;
+    Pixmap buffer;
+    GC buffer_gc;
+    Pixell bg;
 #ifdef USE_XIM
     XIC xic;
     long xic_mask;
@@ -273,6 +281,8 @@ struct infowin {
     int16_t w, h;
     uint16_t b;
 
+    int dirty_x1, dirty_y1, dirty_x2, dirty_y2;
+
     byte byte1;
 
     uint mapped : 1;
@@ -508,6 +518,28 @@ static errr Infowin_set_name(concptr name)
     return 0;
 }
 
+/*
+ * Free the Pixmap of an infowin and the GC and XftDraw made for it
+ */
+static void Infowin_free_buffer(infowin *iwin)
+{
+#ifdef USE_XFT
+    if (iwin->draw) {
+        XftDrawDestroy(iwin->draw);
+        iwin->draw = nullptr;
+    }
+#endif
+    if (iwin->buffer) {
+        XFreePixmap(Metadpy->dpy, iwin->buffer);
+        iwin->buffer = None;
+    }
+
+    if (iwin->buffer_gc) {
+        XFreeGC(Metadpy->dpy, iwin->buffer_gc);
+        iwin->buffer_gc = nullptr;
+    }
+}
+
 /*
  * Prepare a new 'infowin'.
  */
@@ -521,12 +553,24 @@ static errr Infowin_prepare(Window xid)
     iwin->win = xid;
     XGetGeometry(Metadpy->dpy, xid, &tmp_win, &x, &y, &w, &h, &b, &d);
 
+    Infowin_free_buffer(iwin);
+    XGCValues gcv{};
+#ifdef USE_XFT
+    gcv.foreground = iwin->bg.pixel;
+#else
+    gcv.foreground = iwin->bg;
+#endif
+    gcv.graphics_exposures = False;
+    iwin->buffer_gc = XCreateGC(Metadpy->dpy, xid, GCForeground | GCGraphicsExposures, &gcv);
+    iwin->buffer = XCreatePixmap(Metadpy->dpy, xid, w, h, d);
+    XFillRectangle(Metadpy->dpy, iwin->buffer, iwin->buffer_gc, 0, 0, w, h);
+
 #ifdef USE_XFT
     Visual *vis = DefaultVisual(Metadpy->dpy, 0);
     if (vis->c_class != TrueColor) {
         quit_fmt("Display does not support truecolor.\n");
     }
-    iwin->draw = XftDrawCreate(Metadpy->dpy, iwin->win, vis, Metadpy->cmap);
+    iwin->draw = XftDrawCreate(Metadpy->dpy, iwin->buffer, vis, Metadpy->cmap);
 #endif
 
     iwin->x = x;
@@ -570,6 +614,7 @@ static errr Infowin_init_data(Window dad, int x, int y, int w, int h, int b, Pix
 
     XSelectInput(Metadpy->dpy, xid, 0L);
     Infowin->nuke = 1;
+    Infowin->bg = bg;
     return Infowin_prepare(xid);
 }
 
@@ -619,12 +664,69 @@ static errr Infowin_resize(int w, int h)
     return 0;
 }
 
+/*
+ * Remember that a part of the Pixmap of Infowin has been drawn
+ */
+static void Infowin_mark_dirty(int x, int y, int w, int h)
+{
+    if (Infowin->dirty_x2 <= Infowin->dirty_x1) {
+        Infowin->dirty_x1 = x;
+        Infowin->dirty_y1 = y;
+        Infowin->dirty_x2 = x + w;
+        Infowin->dirty_y2 = y + h;
+        return;
+    }
+
+    Infowin->dirty_x1 = std::min(Infowin->dirty_x1, x);
+    Infowin->dirty_y1 = std::min(Infowin->dirty_y1, y);
+    Infowin->dirty_x2 = std::max(Infowin->dirty_x2, x + w);
+    Infowin->dirty_y2 = std::max(Infowin->dirty_y2, y + h);
+}
+
+/*
+ * Copy a part of the Pixmap of Infowin to the Window
+ */
+static void Infowin_copy_buffer(int x, int y, int w, int h)
+{
+    XCopyArea(Metadpy->dpy, Infowin->buffer, Infowin->win, Infowin->buffer_gc, x, y, w, h, x, y);
+}
+
+/*
+ * Copy everything drawn since the last call to the Window at once
+ */
+static void Infowin_present(void)
+{
+    if (Infowin->dirty_x2 <= Infowin->dirty_x1) {
+        return;
+    }
+
+    Infowin_copy_buffer(Infowin->dirty_x1, Infowin->dirty_y1, Infowin->dirty_x2 - Infowin->dirty_x1, Infowin->dirty_y2 - Infowin->dirty_y1);
+    Infowin->dirty_x2 = Infowin->dirty_x1;
+}
+
+/*
+ * Make a new Pixmap of the size of the Window, keeping what was drawn
+ */
+static void Infowin_resize_buffer(int old_w, int old_h)
+{
+    const auto buffer = XCreatePixmap(Metadpy->dpy, Infowin->win, Infowin->w, Infowin->h, Metadpy->depth);
+    XFillRectangle(Metadpy->dpy, buffer, Infowin->buffer_gc, 0, 0, Infowin->w, Infowin->h);
+    XCopyArea(Metadpy->dpy, Infowin->buffer, buffer, Infowin->buffer_gc, 0, 0, std::min<int>(old_w, Infowin->w), std::min<int>(old_h, Infowin->h), 0, 0);
+#ifdef USE_XFT
+    XftDrawChange(Infowin->draw, buffer);
+#endif
+    XFreePixmap(Metadpy->dpy, Infowin->buffer);
+    Infowin->buffer = buffer;
+    Infowin_mark_dirty(0, 0, Infowin->w, Infowin->h);
+}
+
 /*
  * Visually clear Infowin
  */
 static errr Infowin_wipe(void)
 {
-    XClearWindow(Metadpy->dpy, Infowin->win);
+    XFillRectangle(Metadpy->dpy, Infowin->buffer, Infowin->buffer_gc, 0, 0, Infowin->w, Infowin->h);
+    Infowin_mark_dirty(0, 0, Infowin->w, Infowin->h);
     return 0;
 }
 
@@ -888,20 +990,35 @@ static void Infofnt_init_data(concptr name)
 }
 
 #ifdef USE_XFT
+/*
+ * 文字列の各文字を桁の位置に揃えて描く
+ * 1文字ずつ描画要求を送らず、位置を指定した文字の並びとして1回の要求で描く.
+ * 空白は背景を塗った時点で描けているので送らない.
+ */
 static void Infofnt_text_std_xft_draw_str(int px, int py, const XftColor &fg, concptr str, concptr str_end)
 {
+    static std::vector<XftCharSpec> specs;
+    specs.clear();
     int offset = 0;
     while (str < str_end) {
         const int byte_len = utf8_next_char_byte_length(str);
 
         if (byte_len == 0 || str + byte_len > str_end) {
-            return;
+            break;
+        }
+
+        FcChar32 ucs4;
+        if ((*str != ' ') && (FcUtf8ToUcs4((const FcChar8 *)str, &ucs4, byte_len) > 0)) {
+            specs.push_back({ ucs4, static_cast<short>(px + Infofnt->wid * offset), static_cast<short>(py) });
         }
 
-        XftDrawStringUtf8(Infowin->draw, &fg, Infofnt->info, px + Infofnt->wid * offset, py, (const FcChar8 *)str, byte_len);
         offset += (byte_len > 1 ? 2 : 1);
         str += byte_len;
     }
+
+    if (!specs.empty()) {
+        XftDrawCharSpec(Infowin->draw, &fg, Infofnt->info, specs.data(), specs.size());
+    }
 }
 
 static void Infofnt_text_std_xft(int x, int y, int len, const XftColor &fg, const XftColor &bg, const char *str, int utf8_len)
@@ -912,6 +1029,7 @@ static void Infofnt_text_std_xft(int x, int y, int len, const XftColor &fg, cons
     const auto px = (x * Infofnt->wid) + Infowin->ox;
 
     XRectangle r{ 0, 0, static_cast<unsigned short>(Infofnt->wid * len), static_cast<unsigned short>(Infofnt->hgt) };
+    Infowin_mark_dirty(px, py - Infofnt->asc, r.width, r.height);
     XftDrawSetClipRectangles(draw, px, py - Infofnt->asc, &r, 1);
     XftDrawRect(draw, &bg, px, py - Infofnt->asc, r.width, r.height);
     Infofnt_text_std_xft_draw_str(px, py, fg, str, str + utf8_len);
@@ -935,13 +1053,14 @@ static errr Infofnt_text_std(int x, int y, concptr str, int len)
 #ifndef USE_XFT
     y = (y * Infofnt->hgt) + Infofnt->asc + Infowin->oy;
     x = (x * Infofnt->wid) + Infowin->ox;
+    Infowin_mark_dirty(x, y - Infofnt->asc, len * Infofnt->wid, Infofnt->hgt);
 #endif
 
     if (Infofnt->mono) {
 #ifndef USE_XFT
         int i;
         for (i = 0; i < len; ++i) {
-            XDrawImageString(Metadpy->dpy, Infowin->win, Infoclr->gc, x + i * Infofnt->wid + Infofnt->off, y, str + i, 1);
+            XDrawImageString(Metadpy->dpy, Infowin->buffer, Infoclr->gc, x + i * Infofnt->wid + Infofnt->off, y, str + i, 1);
         }
 #endif
     } else {
@@ -956,7 +1075,7 @@ static errr Infofnt_text_std(int x, int y, concptr str, int len)
 #ifdef USE_XFT
         Infofnt_text_std_xft(x, y, len, Infoclr->fg, Infoclr->bg, _(utf8_buf, str), _(utf8_len, len));
 #else
-        XmbDrawImageString(Metadpy->dpy, Infowin->win, Infofnt->info, Infoclr->gc, x, y, _(utf8_buf, str), _(utf8_len, len));
+        XmbDrawImageString(Metadpy->dpy, Infowin->buffer, Infofnt->info, Infoclr->gc, x, y, _(utf8_buf, str), _(utf8_len, len));
 #endif
     }
 
@@ -977,11 +1096,12 @@ static errr Infofnt_text_non(int x, int y, concptr str, int len)
     x = x * Infofnt->wid + Infowin->ox;
     h = Infofnt->hgt;
     y = y * h + Infowin->oy;
+    Infowin_mark_dirty(x, y, w, h);
 
 #ifdef USE_XFT
     XftDrawRect(Infowin->draw, &Infoclr->fg, x, y, w, h);
 #else
-    XFillRectangle(Metadpy->dpy, Infowin->win, Infoclr->gc, x, y, w, h);
+    XFillRectangle(Metadpy->dpy, Infowin->buffer, Infoclr->gc, x, y, w, h);
 #endif
 
     return 0;
@@ -1234,14 +1354,14 @@ auto make_unique_ptr_with_deleter(T *p, D d) noexcept
  */
 static void draw_rectangle_frame(int x, int y, int width, int height)
 {
-    auto gc = make_unique_ptr_with_deleter(XCreateGC(Metadpy->dpy, Infowin->win, 0, NULL),
+    auto gc = make_unique_ptr_with_deleter(XCreateGC(Metadpy->dpy, Infowin->buffer, 0, NULL),
         [dpy = Metadpy->dpy](GC gc) { XFreeGC(dpy, gc); });
 
     XSetForeground(Metadpy->dpy, gc.get(), WhitePixel(Metadpy->dpy, DefaultScreen(Metadpy->dpy)));
-    XDrawLine(Metadpy->dpy, Infowin->win, gc.get(), x, y, x + width, y);
-    XDrawLine(Metadpy->dpy, Infowin->win, gc.get(), x, y, x, y + height);
-    XDrawLine(Metadpy->dpy, Infowin->win, gc.get(), x + width, y, x + width, y + height);
-    XDrawLine(Metadpy->dpy, Infowin->win, gc.get(), x, y + height, x + width, y + height);
+    XDrawLine(Metadpy->dpy, Infowin->buffer, gc.get(), x, y, x + width, y);
+    XDrawLine(Metadpy->dpy, Infowin->buffer, gc.get(), x, y, x, y + height);
+    XDrawLine(Metadpy->dpy, Infowin->buffer, gc.get(), x + width, y, x + width, y + height);
+    XDrawLine(Metadpy->dpy, Infowin->buffer, gc.get(), x, y + height, x + width, y + height);
 }
 #endif
 
@@ -1270,7 +1390,8 @@ static void draw_cursor(int x, int y, int len)
     square_to_pixel(&x, &y, x, y);
     const auto width = Infofnt->wid * len;
     const auto height = Infofnt->hgt;
-    XFillRectangle(Metadpy->dpy, Infowin->win, Infoclr->gc, x, y, width, height);
+    Infowin_mark_dirty(x, y, width, height);
+    XFillRectangle(Metadpy->dpy, Infowin->buffer, Infoclr->gc, x, y, width, height);
 #endif
 }
 
@@ -1291,10 +1412,11 @@ static void mark_selection_mark(int x1, int y1, int x2, int y2)
 {
     square_to_pixel(&x1, &y1, x1, y1);
     square_to_pixel(&x2, &y2, x2, y2);
+    Infowin_mark_dirty(x1, y1, x2 - x1 + Infofnt->wid, y2 - y1 + Infofnt->hgt);
 #ifdef USE_XFT
     draw_rectangle_frame(x1, y1, x2 - x1 + Infofnt->wid - 1, y2 - y1 + Infofnt->hgt - 1);
 #else
-    XDrawRectangle(Metadpy->dpy, Infowin->win, clr[2]->gc, x1, y1, x2 - x1 + Infofnt->wid - 1, y2 - y1 + Infofnt->hgt - 1);
+    XDrawRectangle(Metadpy->dpy, Infowin->buffer, clr[2]->gc, x1, y1, x2 - x1 + Infofnt->wid - 1, y2 - y1 + Infofnt->hgt - 1);
 #endif
 }
 
@@ -1318,6 +1440,7 @@ static void mark_selection(void)
     if (draw) {
         sort_co_ord(&min, &max, &s_ptr->init, &s_ptr->cur);
         mark_selection_mark(min.x, min.y, max.x, max.y);
+        Infowin_present();
     }
 
     if (s_ptr->t != old) {
@@ -1760,14 +1883,8 @@ static errr CheckEvent(bool wait)
         break;
     }
     case Expose: {
-        int x1, x2, y1, y2;
-        x1 = (xev->xexpose.x - Infowin->ox) / Infofnt->wid;
-        x2 = (xev->xexpose.x + xev->xexpose.width - Infowin->ox) / Infofnt->wid;
-
-        y1 = (xev->xexpose.y - Infowin->oy) / Infofnt->hgt;
-        y2 = (xev->xexpose.y + xev->xexpose.height - Infowin->oy) / Infofnt->hgt;
-
-        term_redraw_section(x1, y1, x2, y2);
+        /* 描画済みの内容はピクスマップに残っているので、再描画せずに写すだけでよい */
+        Infowin_copy_buffer(xev->xexpose.x, xev->xexpose.y, xev->xexpose.width, xev->xexpose.height);
         break;
     }
     case MapNotify: {
@@ -1784,10 +1901,16 @@ static errr CheckEvent(bool wait)
         int cols, rows, wid, hgt;
         int ox = Infowin->ox;
         int oy = Infowin->oy;
+        int old_w = Infowin->w;
+        int old_h = Infowin->h;
         Infowin->x = xev->xconfigure.x;
         Infowin->y = xev->xconfigure.y;
         Infowin->w = xev->xconfigure.width;
         Infowin->h = xev->xconfigure.height;
+        if ((Infowin->w != old_w) || (Infowin->h != old_h)) {
+            Infowin_resize_buffer(old_w, old_h);
+        }
+
         cols = ((Infowin->w - (ox + ox)) / td->fnt->wid);
         rows = ((Infowin->h - (oy + oy)) / td->fnt->hgt);
         if (cols < 1) {
@@ -1952,10 +2075,12 @@ static errr game_term_xtra_x11(int n, int v)
         return game_term_xtra_x11_sound(v);
 #ifdef USE_XFT
     case TERM_XTRA_FRESH:
+        Infowin_present();
         Metadpy_update(1, 1, 0);
         return 0;
 #else
     case TERM_XTRA_FRESH:
+        Infowin_present();
         Metadpy_update(1, 0, 0);
         return 0;
 #endif
@@ -1991,15 +2116,16 @@ static errr game_term_xtra_x11(int n, int v)
  */
 static errr game_term_curs_x11(int x, int y)
 {
+    Infowin_mark_dirty(x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->wid, Infofnt->hgt);
     if (use_graphics) {
 #ifdef USE_XFT
         XftDrawRect(Infowin->draw, &xor_->fg, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->wid - 1, Infofnt->hgt - 1);
         XftDrawRect(Infowin->draw, &xor_->fg, x * Infofnt->wid + Infowin->ox + 1, y * Infofnt->hgt + Infowin->oy + 1, Infofnt->wid - 3, Infofnt->hgt - 3);
 #else
         XDrawRectangle(
-            Metadpy->dpy, Infowin->win, xor_->gc, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->wid - 1, Infofnt->hgt - 1);
+            Metadpy->dpy, Infowin->buffer, xor_->gc, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->wid - 1, Infofnt->hgt - 1);
         XDrawRectangle(
-            Metadpy->dpy, Infowin->win, xor_->gc, x * Infofnt->wid + Infowin->ox + 1, y * Infofnt->hgt + Infowin->oy + 1, Infofnt->wid - 3, Infofnt->hgt - 3);
+            Metadpy->dpy, Infowin->buffer, xor_->gc, x * Infofnt->wid + Infowin->ox + 1, y * Infofnt->hgt + Infowin->oy + 1, Infofnt->wid - 3, Infofnt->hgt - 3);
 #endif
     } else {
         Infoclr_set(xor_.get());
@@ -2014,15 +2140,16 @@ static errr game_term_curs_x11(int x, int y)
  */
 static errr game_term_bigcurs_x11(int x, int y)
 {
+    Infowin_mark_dirty(x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->twid, Infofnt->hgt);
     if (use_graphics) {
 #ifdef USE_XFT
         XftDrawRect(Infowin->draw, &xor_->fg, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->twid - 1, Infofnt->hgt - 1);
         XftDrawRect(Infowin->draw, &xor_->fg, x * Infofnt->wid + Infowin->ox + 1, y * Infofnt->hgt + Infowin->oy + 1, Infofnt->twid - 3, Infofnt->hgt - 3);
 #else
         XDrawRectangle(
-            Metadpy->dpy, Infowin->win, xor_->gc, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->twid - 1, Infofnt->hgt - 1);
+            Metadpy->dpy, Infowin->buffer, xor_->gc, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, Infofnt->twid - 1, Infofnt->hgt - 1);
         XDrawRectangle(
-            Metadpy->dpy, Infowin->win, xor_->gc, x * Infofnt->wid + Infowin->ox + 1, y * Infofnt->hgt + Infowin->oy + 1, Infofnt->twid - 3, Infofnt->hgt - 3);
+            Metadpy->dpy, Infowin->buffer, xor_->gc, x * Infofnt->wid + Infowin->ox + 1, y * Infofnt->hgt + Infowin->oy + 1, Infofnt->twid - 3, Infofnt->hgt - 3);
 #endif
     } else {
         Infoclr_set(xor_.get());
@@ -2080,13 +2207,14 @@ static errr game_term_pict_x11(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *
 
     y += Infowin->oy;
     x += Infowin->ox;
+    Infowin_mark_dirty(x, y, (n - 1) * td->fnt->wid + td->fnt->twid, td->fnt->hgt);
     for (i = 0; i < n; ++i, x += td->fnt->wid) {
         a = *ap++;
         c = *cp++;
         x1 = (c & 0x7F) * td->fnt->twid;
         y1 = (a & 0x7F) * td->fnt->hgt;
         if (td->tiles->width < x1 + td->fnt->wid || td->tiles->height < y1 + td->fnt->hgt) {
-            XFillRectangle(Metadpy->dpy, td->win->win, clr[0]->gc, x, y, td->fnt->twid, td->fnt->hgt);
+            XFillRectangle(Metadpy->dpy, td->win->buffer, clr[0]->gc, x, y, td->fnt->twid, td->fnt->hgt);
             continue;
         }
 
@@ -2097,7 +2225,7 @@ static errr game_term_pict_x11(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *
         y2 = (ta & 0x7F) * td->fnt->hgt;
 
         if (((x1 == x2) && (y1 == y2)) || !(((byte)ta & 0x80) && ((byte)tc & 0x80)) || td->tiles->width < x2 + td->fnt->wid || td->tiles->height < y2 + td->fnt->hgt) {
-            XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->tiles, x1, y1, x, y, td->fnt->twid, td->fnt->hgt);
+            XPutImage(Metadpy->dpy, td->win->buffer, clr[0]->gc, td->tiles, x1, y1, x, y, td->fnt->twid, td->fnt->hgt);
         } else {
             blank = XGetPixel(td->tiles, 0, td->fnt->hgt * 6);
             for (k = 0; k < td->fnt->twid; k++) {
@@ -2110,7 +2238,7 @@ static errr game_term_pict_x11(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *
                 }
             }
 
-            XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->TmpImage, 0, 0, x, y, td->fnt->twid, td->fnt->hgt);
+            XPutImage(Metadpy->dpy, td->win->buffer, clr[0]->gc, td->TmpImage, 0, 0, x, y, td->fnt->twid, td->fnt->hgt);
         }
     }
 
@@ -2222,11 +2350,9 @@ static void game_term_nuke_x11(term_type *)
         if (iwin && iwin->xic) {
             XDestroyIC(iwin->xic);
         }
-#ifdef USE_XFT
-        if (iwin && iwin->draw) {
-            XftDrawDestroy(iwin->draw);
+        if (iwin) {
+            Infowin_free_buffer(iwin);
         }
-#endif
         angband_terms[i] = nullptr;
     }
 
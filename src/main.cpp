@@ -15,6 +15,7 @@
 #include "io/signal-handlers.h"
 #include "io/uid-checker.h"
 #include "main-unix/unix-user-ids.h"
+#include "main-unix/zygote-server.h"
 #include "main/angband-initializer.h"
 #include "player/process-name.h"
 #include "system/angband-version.h"
@@ -23,13 +24,16 @@
 #include "system/system-variables.h"
 #include "term/gameterm.h"
 #include "term/term-color-types.h"
+#include "term/z-rand.h"
 #include "util/angband-files.h"
 #include "util/string-processor.h"
 #include "view/display-scores.h"
+#include "wizard/floor-generation-benchmark.h"
 #include "wizard/spoiler-util.h"
 #include "wizard/wizard-spoiler.h"
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 /*
  * Available graphic modes
@@ -180,6 +184,18 @@ static void display_usage(const char *program)
     puts("  -d<def>  Define a 'lib' dir sub-path");
     puts("  --output-spoilers");
     puts("           Output auto generated spoilers and exit");
+    puts("  --floor-benchmark=<dungeon>,<min depth>,<max depth>,<floors>,<seed>");
+    puts("           Generate floors and write statistics to floor-benchmark.csv, then exit");
+    puts("  --frame-rate=<num>");
+    puts("           Update the screen at most <num> times per second while the game runs");
+    puts("  --zygote=<socket>");
+    puts("           Initialize once, then start a GCU session per connection to <socket>");
+    puts("  --zygote-connect=<socket>");
+    puts("           Play on this terminal through the server listening on <socket>");
+    puts("  --spectator-socket=<socket>");
+    puts("           Broadcast the main window to spectators connecting to <socket>");
+    puts("  --spectate=<socket>");
+    puts("           Watch the game broadcasting on <socket>");
     puts("");
 
 #ifdef USE_X11
@@ -208,15 +224,116 @@ static void display_usage(const char *program)
     quit(nullptr);
 }
 
+/*
+ * @brief フロア生成ベンチマークを実行して終了する
+ * @param arg ベンチマークの設定を表す文字列
+ * @return Usageを表示する必要があるか否か
+ */
+static bool exe_floor_generation_benchmark(std::string_view arg)
+{
+    const auto setting = parse_floor_benchmark_setting(arg);
+    if (!setting) {
+        return true;
+    }
+
+    init_stuff();
+    init_angband(p_ptr, true);
+    const auto path = path_build(ANGBAND_DIR_USER, "floor-benchmark.csv");
+    switch (run_floor_generation_benchmark(p_ptr, *setting, path)) {
+    case FloorBenchmarkResultType::SUCCESSFUL:
+        printf("Successfully created %s.\n", path.string().data());
+        quit(nullptr);
+        break;
+    case FloorBenchmarkResultType::INVALID_DUNGEON:
+        quit("Invalid dungeon ID.");
+        break;
+    case FloorBenchmarkResultType::FILE_OPEN_FAILED:
+        quit("Cannot create floor benchmark file.");
+        break;
+    case FloorBenchmarkResultType::FILE_CLOSE_FAILED:
+        quit("Cannot close floor benchmark file.");
+        break;
+    }
+
+    return false;
+}
+
+/* 初期化済みのプロセスからセッション毎に fork するサーバーとして待ち受けるソケット */
+static std::string zygote_socket_path;
+
+/* セッションを依頼するサーバーのソケット */
+static std::string zygote_connect_path;
+
+/* メインウィンドウを観戦者に配信するソケット */
+static std::string spectator_socket_path;
+
+/* 観戦するゲームのソケット */
+static std::string spectate_path;
+
+/*
+ * @brief 画面を実際に更新する頻度の上限を設定する
+ * @param arg 1秒あたりの更新回数を表す文字列. 0なら制限しない
+ * @return 設定できたか否か
+ */
+static bool set_frame_rate(std::string_view arg)
+{
+    try {
+        const auto frame_rate = std::stoi(std::string(arg));
+        if (frame_rate < 0) {
+            return false;
+        }
+
+        arg_frame_rate = frame_rate;
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
 /*
  * @brief 2文字以上のコマンドライン引数 (オプション)を実行する
  * @param opt コマンドライン引数
  * @return Usageを表示する必要があるか否か
- * @details v3.0.0 Alpha21時点では、スポイラー出力モードの判定及び実行を行う
+ * @details スポイラー出力モードとフロア生成ベンチマークの判定及び実行、フレームレートとフォークサーバーの設定を行う
  */
 static bool parse_long_opt(const char *opt)
 {
-    if (strcmp(opt + 2, "output-spoilers") != 0) {
+    constexpr std::string_view floor_benchmark_opt = "floor-benchmark=";
+    constexpr std::string_view frame_rate_opt = "frame-rate=";
+    constexpr std::string_view zygote_opt = "zygote=";
+    constexpr std::string_view zygote_connect_opt = "zygote-connect=";
+    constexpr std::string_view spectator_socket_opt = "spectator-socket=";
+    constexpr std::string_view spectate_opt = "spectate=";
+    const std::string_view long_opt = opt + 2;
+    if (long_opt.starts_with(floor_benchmark_opt)) {
+        return exe_floor_generation_benchmark(long_opt.substr(floor_benchmark_opt.length()));
+    }
+
+    if (long_opt.starts_with(frame_rate_opt)) {
+        return !set_frame_rate(long_opt.substr(frame_rate_opt.length()));
+    }
+
+    if (long_opt.starts_with(zygote_opt)) {
+        zygote_socket_path = long_opt.substr(zygote_opt.length());
+        return zygote_socket_path.empty();
+    }
+
+    if (long_opt.starts_with(zygote_connect_opt)) {
+        zygote_connect_path = long_opt.substr(zygote_connect_opt.length());
+        return zygote_connect_path.empty();
+    }
+
+    if (long_opt.starts_with(spectator_socket_opt)) {
+        spectator_socket_path = long_opt.substr(spectator_socket_opt.length());
+        return spectator_socket_path.empty();
+    }
+
+    if (long_opt.starts_with(spectate_opt)) {
+        spectate_path = long_opt.substr(spectate_opt.length());
+        return spectate_path.empty();
+    }
+
+    if (long_opt != "output-spoilers") {
         return true;
     }
 
@@ -386,6 +503,34 @@ int main(int argc, char *argv[])
         argv[1] = nullptr;
     }
 
+    if (!zygote_connect_path.empty()) {
+        connect_zygote_server(zygote_connect_path, p_ptr->name);
+        quit(nullptr);
+    }
+
+    if (!spectate_path.empty()) {
+        prepare_spectate_stream(spectate_path);
+        browsing_movie = true;
+    }
+
+    /*
+     * 端末に依存しない初期化を済ませてから接続を待ち、ここから先は接続毎に fork した子プロセスで進める.
+     * 子プロセスは受け取った端末で GCU を使う.
+     */
+    const auto is_zygote_session = !zygote_socket_path.empty();
+    if (is_zygote_session) {
+        ANGBAND_SYS = "gcu";
+        init_angband(p_ptr, true);
+        const auto session = run_zygote_server(zygote_socket_path);
+        Rand_state_init();
+        if (!session.term_name.empty()) {
+            setenv("TERM", session.term_name.data(), 1);
+        }
+
+        angband_strcpy(p_ptr->name, session.player_name, sizeof(p_ptr->name));
+        mstr = "gcu";
+    }
+
     process_player_name(p_ptr, true);
     quit_aux = quit_hook;
 
@@ -429,12 +574,16 @@ int main(int argc, char *argv[])
 
     signals_init();
 
-    {
+    if (!is_zygote_session) {
         TermCenteredOffsetSetter tcos(MAIN_TERM_MIN_COLS, MAIN_TERM_MIN_ROWS);
         init_angband(p_ptr, false);
         pause_line(MAIN_TERM_MIN_ROWS - 1);
     }
 
+    if (!spectator_socket_path.empty()) {
+        start_spectator_broadcast(spectator_socket_path);
+    }
+
     play_game(p_ptr, new_game, browsing_movie);
     quit(nullptr);
     return 0;
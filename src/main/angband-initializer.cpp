@@ -21,6 +21,7 @@
 #include "io/uid-checker.h"
 #include "main/game-data-initializer.h"
 #include "main/info-initializer.h"
+#include "main/startup-task-graph.h"
 #include "market/building-initializer.h"
 #include "system/angband-system.h"
 #include "system/dungeon-info.h"
@@ -169,52 +170,74 @@ void init_angband(PlayerType *player_ptr, bool no_term)
 
     void (*init_note)(concptr) = (no_term ? init_note_no_term : init_note_term);
 
-    init_note(_("[データの初期化中... (地形)]", "[Initializing arrays... (features)]"));
+    // 依存関係の無い定義ファイルは並列に読み込み、メッセージとエラーは逐次読み込み時と同じ順序で報告する
+    StartupTaskGraph graph;
+    const auto terrains_task = graph.add([] {
+        try {
+            init_terrains_info();
+            init_feat_variables();
+        } catch (const DefinitionFileError &) {
+            throw;
+        } catch (const std::exception &e) {
+            throw DefinitionFileError(format("地形初期化不能: %s", e.what()));
+        }
+    });
+    const auto baseitems_task = graph.add(init_baseitems_info);
+    const auto artifacts_task = graph.add(init_artifacts_info);
+    const auto egos_task = graph.add(init_egos_info);
+    const auto monraces_task = graph.add(init_monrace_definitions);
+    const auto dungeons_task = graph.add(init_dungeons_info, { terrains_task, monraces_task });
+    const auto spells_task = graph.add(init_spell_info);
+    const auto class_magics_task = graph.add(init_class_magics_info, { spells_task });
+    const auto class_skills_task = graph.add(init_class_skills_info);
+    const auto vaults_task = graph.add(init_vaults_info);
+    graph.launch();
+
     try {
-        init_terrains_info();
-        init_feat_variables();
-    } catch (const std::exception &e) {
-        quit_fmt("地形初期化不能: %s", e.what());
-    }
+        init_note(_("[データの初期化中... (地形)]", "[Initializing arrays... (features)]"));
+        graph.wait(terrains_task);
 
-    init_note(_("[データの初期化中... (アイテム)]", "[Initializing arrays... (objects)]"));
-    init_baseitems_info();
+        init_note(_("[データの初期化中... (アイテム)]", "[Initializing arrays... (objects)]"));
+        graph.wait(baseitems_task);
 
-    init_note(_("[データの初期化中... (伝説のアイテム)]", "[Initializing arrays... (artifacts)]"));
-    init_artifacts_info();
+        init_note(_("[データの初期化中... (伝説のアイテム)]", "[Initializing arrays... (artifacts)]"));
+        graph.wait(artifacts_task);
 
-    init_note(_("[データの初期化中... (名のあるアイテム)]", "[Initializing arrays... (ego-items)]"));
-    init_egos_info();
+        init_note(_("[データの初期化中... (名のあるアイテム)]", "[Initializing arrays... (ego-items)]"));
+        graph.wait(egos_task);
 
-    init_note(_("[データの初期化中... (モンスター)]", "[Initializing arrays... (monsters)]"));
-    init_monrace_definitions();
+        init_note(_("[データの初期化中... (モンスター)]", "[Initializing arrays... (monsters)]"));
+        graph.wait(monraces_task);
 
-    init_note(_("[データの初期化中... (ダンジョン)]", "[Initializing arrays... (dungeon)]"));
-    init_dungeons_info();
+        init_note(_("[データの初期化中... (ダンジョン)]", "[Initializing arrays... (dungeon)]"));
+        graph.wait(dungeons_task);
 
-    init_note(_("[データの初期化中... (呪文情報)]", "[Initializing arrays... (magic)]"));
-    init_spell_info();
+        init_note(_("[データの初期化中... (呪文情報)]", "[Initializing arrays... (magic)]"));
+        graph.wait(spells_task);
 
-    init_note(_("[データの初期化中... (魔法)]", "[Initializing arrays... (magic)]"));
-    init_class_magics_info();
+        init_note(_("[データの初期化中... (魔法)]", "[Initializing arrays... (magic)]"));
+        graph.wait(class_magics_task);
 
-    init_note(_("[データの初期化中... (熟練度)]", "[Initializing arrays... (skill)]"));
-    init_class_skills_info();
+        init_note(_("[データの初期化中... (熟練度)]", "[Initializing arrays... (skill)]"));
+        graph.wait(class_skills_task);
 
-    init_note(_("[配列を初期化しています... (荒野)]", "[Initializing arrays... (wilderness)]"));
-    init_wilderness();
+        init_note(_("[配列を初期化しています... (荒野)]", "[Initializing arrays... (wilderness)]"));
+        init_wilderness();
 
-    init_note(_("[配列を初期化しています... (街)]", "[Initializing arrays... (towns)]"));
-    init_towns();
+        init_note(_("[配列を初期化しています... (街)]", "[Initializing arrays... (towns)]"));
+        init_towns();
 
-    init_note(_("[配列を初期化しています... (建物)]", "[Initializing arrays... (buildings)]"));
-    init_buildings();
+        init_note(_("[配列を初期化しています... (建物)]", "[Initializing arrays... (buildings)]"));
+        init_buildings();
 
-    init_note(_("[配列を初期化しています... (クエスト)]", "[Initializing arrays... (quests)]"));
-    QuestList::get_instance().initialize();
+        init_note(_("[配列を初期化しています... (クエスト)]", "[Initializing arrays... (quests)]"));
+        QuestList::get_instance().initialize();
 
-    init_note(_("[データの初期化中... (宝物庫)]", "[Initializing arrays... (vaults)]"));
-    init_vaults_info();
+        init_note(_("[データの初期化中... (宝物庫)]", "[Initializing arrays... (vaults)]"));
+        graph.wait(vaults_task);
+    } catch (const DefinitionFileError &e) {
+        quit(e.what());
+    }
 
     init_note(_("[データの初期化中... (その他)]", "[Initializing arrays... (other)]"));
     init_other(player_ptr);
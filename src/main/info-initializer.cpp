@@ -14,6 +14,7 @@
 #include "info-reader/fixed-map-parser.h"
 #include "info-reader/general-parser.h"
 #include "info-reader/info-reader-util.h"
+#include "info-reader/json-element-reader.h"
 #include "info-reader/magic-reader.h"
 #include "info-reader/race-reader.h"
 #include "info-reader/skill-reader.h"
@@ -38,9 +39,15 @@
 #include "util/string-processor.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <string>
 #include <string_view>
+#include <vector>
 #include <sys/stat.h>
 #ifndef WINDOWS
 #include <sys/types.h>
@@ -50,6 +57,24 @@ namespace {
 
 using Retoucher = void (*)();
 
+constexpr std::string_view DEFINITION_CACHE_MAGIC("HBDC"); //!< 解析済み定義データキャッシュの識別子
+constexpr uint32_t DEFINITION_CACHE_VERSION = 4; //!< 解析済み定義データキャッシュの形式のバージョン
+constexpr size_t DEFINITION_READ_CHUNK_SIZE = 64 * 1024; //!< 定義ファイルを読み込む際の1回あたりのバイト数
+
+/*!
+ * @brief キャッシュファイルの書き込み/削除の排他制御
+ * @details 実効ユーザーIDの切り替えはプロセス全体に及ぶため、並列に読み込んでいるスレッド間で排他する.
+ */
+std::mutex definition_cache_mutex;
+
+/*!
+ * @brief 読み込んだ定義ファイル
+ */
+struct DefinitionSource {
+    std::string contents; //!< ファイルの内容
+    util::SHA256::Digest digest{}; //!< 改行コードの差異を除いたファイルの内容のハッシュ値
+};
+
 /// @note clang-formatによるconceptの整形が安定していないので抑制しておく
 // clang-format off
 template <typename T>
@@ -76,6 +101,7 @@ static void init_header(angband_header *head)
  * @param filename ファイル名(拡張子txt)
  * @param head 処理に用いるヘッダ構造体
  * @param info データ保管先の構造体ポインタ
+ * @throw DefinitionFileError ファイルを開けないか、解析に失敗した場合
  * @note
  * Note that we let each entry have a unique "name" and "text" string,
  * even if the string happens to be empty (everyone has a unique '\0').
@@ -86,7 +112,7 @@ static void init_info(std::string_view filename, angband_header &head, InfoType
     const auto path = path_build(ANGBAND_DIR_EDIT, filename);
     auto *fp = angband_fopen(path, FileOpenMode::READ);
     if (!fp) {
-        quit_fmt(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data());
+        throw DefinitionFileError(format(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data()));
     }
 
     char buf[1024]{};
@@ -102,7 +128,7 @@ static void init_info(std::string_view filename, angband_header &head, InfoType
         msg_format(_("レコード %d は '%s' エラーがあります。", "Record %d contains a '%s' error."), error_idx, oops);
         msg_format(_("構文 '%s'。", "Parsing '%s'."), buf);
         msg_print(nullptr);
-        quit_fmt(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data());
+        throw DefinitionFileError(format(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data()));
     }
 
     if constexpr (HasShrinkToFit<InfoType>) {
@@ -114,12 +140,235 @@ static void init_info(std::string_view filename, angband_header &head, InfoType
     }
 }
 
+/*!
+ * @brief ファイルの内容を一括で読み込む
+ * @param path ファイルのパス
+ * @return ファイルの内容。読み込めなければstd::nullopt
+ */
+static std::optional<std::string> read_whole_file(const std::filesystem::path &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        return std::nullopt;
+    }
+
+    ifs.seekg(0, std::ios::end);
+    const auto size = static_cast<size_t>(ifs.tellg());
+    ifs.seekg(0, std::ios::beg);
+    std::string contents(size, '\0');
+    if (!ifs.read(contents.data(), size)) {
+        return std::nullopt;
+    }
+
+    return contents;
+}
+
+/*!
+ * @brief 定義ファイルを読み込みながらハッシュ値を計算する
+ * @param path ファイルのパス
+ * @return 読み込んだ定義ファイル。読み込めなければstd::nullopt
+ * @details
+ * 環境によって改行コードがCRLFに変換されていてもキャラクタダンプのチェックサムが変わらないよう、
+ * CRを除いてハッシュ値を計算する.
+ */
+static std::optional<DefinitionSource> read_definition_source(const std::filesystem::path &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        return std::nullopt;
+    }
+
+    ifs.seekg(0, std::ios::end);
+    const auto size = static_cast<size_t>(ifs.tellg());
+    ifs.seekg(0, std::ios::beg);
+    DefinitionSource source{ std::string(size, '\0') };
+    util::SHA256 sha256;
+    for (size_t pos = 0; pos < size; pos += DEFINITION_READ_CHUNK_SIZE) {
+        const auto chunk_size = std::min(DEFINITION_READ_CHUNK_SIZE, size - pos);
+        if (!ifs.read(source.contents.data() + pos, chunk_size)) {
+            return std::nullopt;
+        }
+
+        std::string_view chunk(source.contents.data() + pos, chunk_size);
+        while (!chunk.empty()) {
+            const auto cr_pos = chunk.find('\r');
+            sha256.update(chunk.substr(0, cr_pos));
+            chunk.remove_prefix((cr_pos == std::string_view::npos) ? chunk.size() : cr_pos + 1);
+        }
+    }
+
+    source.digest = sha256.digest();
+    return source;
+}
+
+/*!
+ * @brief 解析済み定義データのキャッシュファイルのパスを返す
+ * @param filename 定義ファイルのファイル名
+ * @return キャッシュファイルのパス
+ */
+static std::filesystem::path build_definition_cache_path(std::string_view filename)
+{
+    auto cache_filename = std::filesystem::path(filename).replace_extension(".cache");
+    return path_build(ANGBAND_DIR_DATA, cache_filename.string());
+}
+
+/*!
+ * @brief 壊れた解析済み定義データのキャッシュを削除する
+ * @param path キャッシュファイルのパス
+ */
+static void remove_definition_cache(const std::filesystem::path &path)
+{
+    std::lock_guard lock(definition_cache_mutex);
+    safe_setuid_grab();
+    fd_kill(path);
+    safe_setuid_drop();
+}
+
+/*!
+ * @brief キャッシュの本体が書いたときのままかを確かめるためのハッシュ値を計算する (FNV-1a 64bit)
+ * @param payload MessagePack形式の定義データ
+ * @return ハッシュ値
+ * @details 壊れたキャッシュを解析器に渡す前に検出できればよいので、暗号学的ハッシュより軽いものを使う
+ */
+static uint64_t calc_definition_cache_checksum(std::string_view payload)
+{
+    auto hash = 14695981039346656037ULL;
+    for (const auto c : payload) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/*!
+ * @brief 解析済み定義データのキャッシュを読み込む
+ * @param path キャッシュファイルのパス
+ * @param source_digest 定義ファイルの内容のハッシュ値
+ * @return MessagePack形式の定義データ。キャッシュが存在しないか、定義ファイルと一致しないか、壊れていればstd::nullopt
+ * @details
+ * 形式は識別子(4バイト), バージョン(4バイト), 定義ファイルのハッシュ値, 定義データのバイト数(8バイト),
+ * 定義データのハッシュ値(8バイト), MessagePack形式の定義データの順.
+ * 定義データは読み込みに使用するキーとその配列のみを持つオブジェクトとする.
+ * 解析の途中で壊れていると分かっても読み込んだ分を取り消せないため、解析器に渡す前に全体を検査する.
+ * 壊れたキャッシュは削除し、呼び出し元は定義ファイルの解析に戻る.
+ */
+static std::optional<std::string> read_definition_cache(const std::filesystem::path &path, const util::SHA256::Digest &source_digest)
+{
+    auto contents = read_whole_file(path);
+    constexpr auto header_size = DEFINITION_CACHE_MAGIC.length() + sizeof(uint32_t) + util::SHA256::DIGEST_SIZE + sizeof(uint64_t) * 2;
+    if (!contents) {
+        return std::nullopt;
+    }
+
+    if ((contents->size() < header_size) || !contents->starts_with(DEFINITION_CACHE_MAGIC)) {
+        remove_definition_cache(path);
+        return std::nullopt;
+    }
+
+    auto pos = DEFINITION_CACHE_MAGIC.length();
+    uint32_t version;
+    std::memcpy(&version, contents->data() + pos, sizeof(version));
+    pos += sizeof(version);
+    if ((version != DEFINITION_CACHE_VERSION) || (std::memcmp(contents->data() + pos, source_digest.data(), source_digest.size()) != 0)) {
+        return std::nullopt;
+    }
+
+    pos += source_digest.size();
+    uint64_t payload_size;
+    uint64_t checksum;
+    std::memcpy(&payload_size, contents->data() + pos, sizeof(payload_size));
+    pos += sizeof(payload_size);
+    std::memcpy(&checksum, contents->data() + pos, sizeof(checksum));
+    const auto payload = std::string_view(*contents).substr(header_size);
+    if ((payload.size() != payload_size) || (calc_definition_cache_checksum(payload) != checksum)) {
+        remove_definition_cache(path);
+        return std::nullopt;
+    }
+
+    contents->erase(0, header_size);
+    return contents;
+}
+
+/*!
+ * @brief キャッシュに書き込む定義データの先頭部分を作る
+ * @param keyname 読み込みに使用するキー
+ * @return MessagePack形式の定義データの先頭部分
+ * @details 配列の要素数は要素を全て加えた後に set_definition_cache_size() で設定する.
+ */
+static std::vector<uint8_t> build_definition_cache_prefix(std::string_view keyname)
+{
+    std::vector<uint8_t> msgpack{ 0x81 }; // 要素数1のmap
+    nlohmann::json::to_msgpack(nlohmann::json(keyname), msgpack);
+    msgpack.insert(msgpack.end(), { 0xdd, 0, 0, 0, 0 }); // 要素数を32bitで表すarray
+    return msgpack;
+}
+
+/*!
+ * @brief キャッシュに書き込む定義データの配列の要素数を設定する
+ * @param msgpack build_definition_cache_prefix() で作り、要素を加えた定義データ
+ * @param keyname 読み込みに使用するキー
+ * @param size 配列の要素数
+ */
+static void set_definition_cache_size(std::vector<uint8_t> &msgpack, std::string_view keyname, uint32_t size)
+{
+    const auto pos = build_definition_cache_prefix(keyname).size() - sizeof(size);
+    for (auto i = 0U; i < sizeof(size); i++) {
+        msgpack[pos + i] = static_cast<uint8_t>(size >> (8 * (sizeof(size) - 1 - i))); // ビッグエンディアン
+    }
+}
+
+/*!
+ * @brief 解析済み定義データのキャッシュを書き込む
+ * @param path キャッシュファイルのパス
+ * @param source_digest 定義ファイルの内容のハッシュ値
+ * @param msgpack MessagePack形式の定義データ
+ * @details
+ * 同時に起動した他のプロセスが書きかけのキャッシュを読まないよう、一時ファイルに書き切ってから置き換える.
+ * 書き込めなかった場合は次回の起動時に再び定義ファイルを解析するだけなので、エラーは無視する.
+ */
+static void write_definition_cache(const std::filesystem::path &path, const util::SHA256::Digest &source_digest, const std::vector<uint8_t> &msgpack)
+{
+    std::lock_guard lock(definition_cache_mutex);
+    auto temp_path = path;
+    temp_path += format(".%08x.tmp", std::random_device()());
+    safe_setuid_grab();
+    auto *fp = angband_fopen(temp_path, FileOpenMode::WRITE, true);
+    safe_setuid_drop();
+    if (!fp) {
+        return;
+    }
+
+    const auto version = DEFINITION_CACHE_VERSION;
+    const uint64_t payload_size = msgpack.size();
+    const auto checksum = calc_definition_cache_checksum({ reinterpret_cast<const char *>(msgpack.data()), msgpack.size() });
+    auto is_written = fwrite(DEFINITION_CACHE_MAGIC.data(), 1, DEFINITION_CACHE_MAGIC.length(), fp) == DEFINITION_CACHE_MAGIC.length();
+    is_written &= fwrite(&version, sizeof(version), 1, fp) == 1;
+    is_written &= fwrite(source_digest.data(), 1, source_digest.size(), fp) == source_digest.size();
+    is_written &= fwrite(&payload_size, sizeof(payload_size), 1, fp) == 1;
+    is_written &= fwrite(&checksum, sizeof(checksum), 1, fp) == 1;
+    is_written &= fwrite(msgpack.data(), 1, msgpack.size(), fp) == msgpack.size();
+    is_written &= angband_fclose(fp) == 0;
+    safe_setuid_grab();
+    if (is_written) {
+        fd_move(temp_path, path);
+    }
+
+    fd_kill(temp_path); // 書き込みか置き換えに失敗した一時ファイルを残さない
+    safe_setuid_drop();
+}
+
 /*!
  * @brief 各種設定データをlib/edit/.jsoncから読み込み
  * Load data from lib/edit/.jsonc
  * @param filename ファイル名(拡張子jsonc)
  * @param head 処理に用いるヘッダ構造体
  * @param info データ保管先の構造体ポインタ
+ * @throw DefinitionFileError ファイルを開けないか、解析に失敗した場合
+ * @details
+ * JSONの構文解析の結果をMessagePack形式でキャッシュし、次回以降の起動では構文解析を省く.
+ * 各要素の解析器が構築した定義データそのものはキャッシュしない.
+ * 解析器の処理は定義ファイルの読み込み全体の1割程度しかなく、定義データの型ごとに直列化を用意する手間に見合わないため.
+ * 同じ理由で、合計しても読み込み全体の1割に満たない.txtの定義ファイルもキャッシュしない.
  * @note
  * Note that we let each entry have a unique "name" and "text" string,
  * even if the string happens to be empty (everyone has a unique '\0').
@@ -128,29 +377,58 @@ template <typename InfoType>
 static void init_json(std::string_view filename, std::string_view keyname, angband_header &head, InfoType &info, JSONParser parser)
 {
     const auto path = path_build(ANGBAND_DIR_EDIT, filename);
-    std::ifstream ifs(path);
-
-    if (!ifs) {
-        quit_fmt(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data());
+    const auto source = read_definition_source(path);
+    if (!source) {
+        throw DefinitionFileError(format(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data()));
     }
 
-    std::istreambuf_iterator<char> ifs_iter(ifs);
-    std::istreambuf_iterator<char> ifs_end;
-    auto json_object = nlohmann::json::parse(ifs_iter, ifs_end, nullptr, true, true);
+    head.digest = source->digest;
+    const auto cache_path = build_definition_cache_path(filename);
+    const auto cache = read_definition_cache(cache_path, source->digest);
+    std::vector<uint8_t> msgpack;
+    uint32_t num_elements = 0;
+    if (!cache) {
+        msgpack = build_definition_cache_prefix(keyname);
+    }
 
     error_idx = -1;
 
-    for (auto &element : json_object[keyname]) {
+    // DOM全体を構築せず、配列の要素を1つずつ解析して破棄する
+    JSONArrayElementReader reader(keyname, [&](nlohmann::json &element) {
+        if (!cache) {
+            // パーサが要素を書き換える可能性があるため、解析前の状態をキャッシュする
+            nlohmann::json::to_msgpack(element, msgpack);
+            num_elements++;
+        }
+
         const auto error_code = parser(element, &head);
         if (error_code != PARSE_ERROR_NONE) {
             msg_print(nullptr);
-            quit_fmt(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data());
+            throw DefinitionFileError(format(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data()));
+        }
+    });
+
+    try {
+        if (cache) {
+            nlohmann::json::sax_parse(cache->begin(), cache->end(), &reader, nlohmann::json::input_format_t::msgpack);
+        } else {
+            nlohmann::json::sax_parse(source->contents, &reader, nlohmann::json::input_format_t::json, true, true);
+        }
+    } catch (const nlohmann::json::exception &e) {
+        if (cache) {
+            // 壊れたキャッシュは次回の起動時に作り直す
+            remove_definition_cache(cache_path);
         }
+
+        msg_print(e.what());
+        msg_print(nullptr);
+        throw DefinitionFileError(format(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data()));
     }
 
-    util::SHA256 sha256;
-    sha256.update(json_object.dump());
-    head.digest = sha256.digest();
+    if (!cache) {
+        set_definition_cache_size(msgpack, keyname, num_elements);
+        write_definition_cache(cache_path, source->digest, msgpack);
+    }
 
     if constexpr (HasShrinkToFit<InfoType>) {
         info.shrink_to_fit();
@@ -4,6 +4,17 @@
  * @brief 変愚蛮怒のゲームデータ解析処理ヘッダ
  */
 
+#include <stdexcept>
+
+/*!
+ * @brief 定義ファイルを読み込めなかったことを表す例外
+ * @details メッセージはゲームを終了する際にそのまま表示する.
+ */
+class DefinitionFileError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 void init_artifacts_info();
 void init_baseitems_info();
 void init_class_magics_info();
@@ -0,0 +1,96 @@
+/*!
+ * @file startup-task-graph.cpp
+ * @brief 起動時の初期化処理を依存関係に従って並列に実行するタスクグラフの実装
+ */
+
+#include "main/startup-task-graph.h"
+#include <stdexcept>
+
+/*!
+ * @brief 実行中のタスクが残っていれば完了を待つ
+ * @details 例外による脱出時にもワーカースレッドが破棄済みの変数へ触れないようにするため.
+ */
+StartupTaskGraph::~StartupTaskGraph()
+{
+    this->wait_all();
+}
+
+/*!
+ * @brief タスクを登録する
+ * @param task 実行する処理
+ * @param dependencies 完了を待つタスクのID (登録済みのものに限る)
+ * @return 登録したタスクのID
+ */
+size_t StartupTaskGraph::add(std::function<void()> task, std::vector<size_t> dependencies)
+{
+    const auto id = this->tasks.size();
+    for (const auto dependency : dependencies) {
+        if (dependency >= id) {
+            throw std::invalid_argument("Startup task depends on an unregistered task");
+        }
+    }
+
+    this->tasks.push_back({ std::move(task), std::move(dependencies), {}, nullptr, {} });
+    return id;
+}
+
+/*!
+ * @brief 登録した全てのタスクの実行を開始する
+ * @details 依存先は必ず先に登録されているため、登録順に開始すれば待ち合わせが循環することはない.
+ */
+void StartupTaskGraph::launch()
+{
+    for (auto &task : this->tasks) {
+        task.result = std::async(std::launch::async, [this, &task] { return this->execute(task); }).share();
+    }
+}
+
+/*!
+ * @brief タスクの完了を待ち、保留されたメッセージを出力する
+ * @param id 待つタスクのID
+ * @details タスクが例外を送出していた場合は、他のタスクの完了を待ってから同じ例外を送出する.
+ */
+void StartupTaskGraph::wait(size_t id)
+{
+    auto &task = this->tasks.at(id);
+    task.result.wait();
+    msg_print_deferred(task.messages);
+    task.messages.clear();
+    if (task.error) {
+        this->wait_all();
+        std::rethrow_exception(task.error);
+    }
+}
+
+/*!
+ * @brief ワーカースレッドでタスクを実行する
+ * @param task 実行するタスク
+ * @return 成功したか否か
+ */
+bool StartupTaskGraph::execute(Task &task)
+{
+    for (const auto dependency : task.dependencies) {
+        if (!this->tasks[dependency].result.get()) {
+            return false;
+        }
+    }
+
+    msg_defer(&task.messages);
+    try {
+        task.function();
+    } catch (...) {
+        task.error = std::current_exception();
+    }
+
+    msg_defer(nullptr);
+    return !task.error;
+}
+
+void StartupTaskGraph::wait_all()
+{
+    for (auto &task : this->tasks) {
+        if (task.result.valid()) {
+            task.result.wait();
+        }
+    }
+}
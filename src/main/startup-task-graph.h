@@ -0,0 +1,47 @@
+#pragma once
+/*!
+ * @file startup-task-graph.h
+ * @brief 起動時の初期化処理を依存関係に従って並列に実行するタスクグラフの宣言
+ */
+
+#include "view/display-messages.h"
+#include <exception>
+#include <functional>
+#include <future>
+#include <vector>
+
+/*!
+ * @brief 起動時の初期化タスクグラフ
+ * @details
+ * 登録したタスクを launch() でワーカースレッドに割り当て、依存するタスクの完了を待ってから実行する.
+ * タスク中のメッセージ出力は保留され、wait() を呼び出したメインスレッドで出力される.
+ * wait() を逐次実行時と同じ順序で呼び出せば、メッセージの出力順とエラーの報告は逐次実行時と一致する.
+ */
+class StartupTaskGraph {
+public:
+    StartupTaskGraph() = default;
+    ~StartupTaskGraph();
+    StartupTaskGraph(const StartupTaskGraph &) = delete;
+    StartupTaskGraph &operator=(const StartupTaskGraph &) = delete;
+
+    size_t add(std::function<void()> task, std::vector<size_t> dependencies = {});
+    void launch();
+    void wait(size_t id);
+
+private:
+    /*!
+     * @brief 1つの初期化タスク
+     */
+    struct Task {
+        std::function<void()> function; //!< 実行する処理
+        std::vector<size_t> dependencies; //!< 完了を待つタスクのID
+        DeferredMessages messages; //!< 実行中に保留したメッセージ
+        std::exception_ptr error; //!< 実行中に送出された例外
+        std::shared_future<bool> result; //!< 成功したか否か (依存先が失敗した場合は実行せずに失敗とする)
+    };
+
+    std::vector<Task> tasks;
+
+    bool execute(Task &task);
+    void wait_all();
+};
@@ -33,7 +33,9 @@
 #include "util/string-processor.h"
 #include "view/display-messages.h"
 #include "wizard/wizard-messages.h"
+#include <algorithm>
 #include <optional>
+#include <vector>
 
 #define MON_SCAT_MAXD 10 /*!< mon_scatter()関数によるモンスター配置で許される中心からの最大距離 */
 
@@ -493,6 +495,74 @@ bool alloc_guardian(PlayerType *player_ptr, bool def_val)
     return false;
 }
 
+/*!
+ * @brief モンスターを配置できるマスかを判定する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param pos 判定するマスの座標
+ * @param min_dis プレイヤーから離れるべき最小距離
+ * @param max_dis プレイヤーから離れるべき最大距離
+ * @return 配置できるか否か
+ */
+static bool is_monster_allocatable(PlayerType *player_ptr, const Pos2D &pos, int min_dis, int max_dis)
+{
+    if (player_ptr->current_floor_ptr->dun_level) {
+        if (!is_cave_empty_bold2(player_ptr, pos.y, pos.x)) {
+            return false;
+        }
+    } else {
+        if (!is_cave_empty_bold(player_ptr, pos.y, pos.x)) {
+            return false;
+        }
+    }
+
+    const auto dist = distance(pos.y, pos.x, player_ptr->y, player_ptr->x);
+    return (min_dis < dist) && (dist <= max_dis);
+}
+
+/*!
+ * @brief モンスターを配置するマスを選ぶ
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param min_dis プレイヤーから離れるべき最小距離
+ * @param max_dis プレイヤーから離れるべき最大距離
+ * @return 選んだマスの座標。配置できるマスが無ければstd::nullopt
+ * @details
+ * 空きマスが多い通常のフロアでは無作為に数回選べば見つかるため、まずはそれを試す.
+ * 見つからなければ混雑したフロアや狭いフロアとみなし、配置できるマスを全て列挙してから選ぶ.
+ * 最大距離が短ければプレイヤーの周囲だけを調べる. どちらの方法でも配置できるマスから一様に選ばれる.
+ */
+static std::optional<Pos2D> select_monster_allocation_grid(PlayerType *player_ptr, int min_dis, int max_dis)
+{
+    constexpr auto random_attempts = 100;
+    const auto &floor = *player_ptr->current_floor_ptr;
+    for (auto i = 0; i < random_attempts; i++) {
+        const Pos2D pos(randint0(floor.height), randint0(floor.width));
+        if (is_monster_allocatable(player_ptr, pos, min_dis, max_dis)) {
+            return pos;
+        }
+    }
+
+    const auto is_near = max_dis < std::max(floor.height, floor.width);
+    const auto y_min = is_near ? std::max(0, player_ptr->y - max_dis) : 0;
+    const auto y_max = is_near ? std::min(floor.height - 1, player_ptr->y + max_dis) : floor.height - 1;
+    const auto x_min = is_near ? std::max(0, player_ptr->x - max_dis) : 0;
+    const auto x_max = is_near ? std::min(floor.width - 1, player_ptr->x + max_dis) : floor.width - 1;
+    std::vector<Pos2D> candidates;
+    for (auto y = y_min; y <= y_max; y++) {
+        for (auto x = x_min; x <= x_max; x++) {
+            const Pos2D pos(y, x);
+            if (is_monster_allocatable(player_ptr, pos, min_dis, max_dis)) {
+                candidates.push_back(pos);
+            }
+        }
+    }
+
+    if (candidates.empty()) {
+        return std::nullopt;
+    }
+
+    return candidates[randint0(static_cast<int>(candidates.size()))];
+}
+
 /*!
  * @brief ダンジョンの初期配置モンスターを生成1回生成する / Attempt to allocate a random monster in the dungeon.
  * @param dis プレイヤーから離れるべき最小距離
@@ -508,30 +578,8 @@ bool alloc_monster(PlayerType *player_ptr, int min_dis, BIT_FLAGS mode, summon_s
     }
 
     auto *floor_ptr = player_ptr->current_floor_ptr;
-    auto y = 0;
-    auto x = 0;
-    auto attempts_left = 10000;
-    while (attempts_left--) {
-        y = randint0(floor_ptr->height);
-        x = randint0(floor_ptr->width);
-
-        if (floor_ptr->dun_level) {
-            if (!is_cave_empty_bold2(player_ptr, y, x)) {
-                continue;
-            }
-        } else {
-            if (!is_cave_empty_bold(player_ptr, y, x)) {
-                continue;
-            }
-        }
-
-        const auto dist = distance(y, x, player_ptr->y, player_ptr->x);
-        if ((min_dis < dist) && (dist <= max_dis)) {
-            break;
-        }
-    }
-
-    if (!attempts_left) {
+    const auto pos = select_monster_allocation_grid(player_ptr, min_dis, max_dis);
+    if (!pos) {
         if (cheat_xtra || cheat_hear) {
             msg_print(_("警告！新たなモンスターを配置できません。小さい階ですか？", "Warning! Could not allocate a new monster. Small level?"));
         }
@@ -539,6 +587,7 @@ bool alloc_monster(PlayerType *player_ptr, int min_dis, BIT_FLAGS mode, summon_s
         return false;
     }
 
+    const auto [y, x] = *pos;
     if (randint1(5000) <= floor_ptr->dun_level) {
         if (alloc_horde(player_ptr, y, x, summon_specific)) {
             return true;
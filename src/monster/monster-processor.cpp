@@ -65,6 +65,7 @@
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
 #include "system/redrawing-flags-updater.h"
+#include "system/rng-stream-guard.h"
 #include "target/projection-path-calculator.h"
 #include "tracking/lore-tracker.h"
 #include "view/display-messages.h"
@@ -643,6 +644,7 @@ void process_monsters(PlayerType *player_ptr)
  */
 void sweep_monster_process(PlayerType *player_ptr)
 {
+    const RngStreamGuard rng_guard(RngStream::MONSTER_AI);
     auto &floor = *player_ptr->current_floor_ptr;
 
     // 処理中の召喚などで生成されたモンスターが即座に行動しないようにするため、
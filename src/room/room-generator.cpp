@@ -1,5 +1,6 @@
 #include "room/room-generator.h"
 #include "dungeon/dungeon-flag-types.h"
+#include "floor/floor-generation-statistics.h"
 #include "game-option/birth-options.h"
 #include "game-option/cheat-types.h"
 #include "room/door-definition.h"
@@ -200,6 +201,7 @@ bool generate_rooms(PlayerType *player_ptr, dun_data_type *dd_ptr)
             }
 
             rooms_built++;
+            FloorGenerationStatistics::get_instance().add_room(room_type);
             remain = true;
             switch (room_type) {
             case RoomType::PIT:
@@ -7,6 +7,7 @@
 #include "room/rooms-vault.h"
 #include "dungeon/dungeon-flag-types.h"
 #include "floor/cave.h"
+#include "floor/floor-generation-statistics.h"
 #include "floor/floor-generator-util.h"
 #include "floor/floor-generator.h"
 #include "floor/floor-town.h"
@@ -296,303 +297,307 @@ static void coord_trans(POSITION *x, POSITION *y, POSITION xoffset, POSITION yof
 }
 
 /*!
- * @brief Vaultをフロアに配置する / Hack -- fill in "vault" rooms
- * @param player_ptr プレイヤーへの参照ポインタ
- * @param yval 生成基準Y座標
- * @param xval 生成基準X座標
- * @param ymax VaultのYサイズ
- * @param xmax VaultのXサイズ
- * @param data Vaultのデータ文字列
- * @param xoffset 変換基準X座標
- * @param yoffset 変換基準Y座標
- * @param transno 変換ID
+ * @brief 回転・反転後のVaultの配置情報を得る
+ * @param transno 変換ID (0-7)
+ * @return 配置情報
+ * @details 定義文字列の解釈と座標変換は向き毎に初回だけ行い、以降は保持したものを返す.
  */
-static void build_vault(
-    PlayerType *player_ptr, POSITION yval, POSITION xval, POSITION ymax, POSITION xmax, concptr data, POSITION xoffset, POSITION yoffset, int transno)
+const VaultLayout &vault_type::get_layout(int transno) const
 {
-    POSITION dx, dy, x, y, i, j;
-    concptr t;
-    Grid *g_ptr;
-
-    /* Place dungeon features and objects */
-    auto *floor_ptr = player_ptr->current_floor_ptr;
-    for (t = data, dy = 0; dy < ymax; dy++) {
-        for (dx = 0; dx < xmax; dx++, t++) {
-            /* prevent loop counter from being overwritten */
-            i = dx;
-            j = dy;
+    auto &layout = this->layouts.at(transno);
+    if (layout) {
+        return *layout;
+    }
 
-            /* Flip / rotate */
-            coord_trans(&i, &j, xoffset, yoffset, transno);
-
-            if (transno % 2 == 0) {
-                /* no swap of x/y */
-                x = xval - (xmax / 2) + i;
-                y = yval - (ymax / 2) + j;
-            } else {
-                /* swap of x/y */
-                x = xval - (ymax / 2) + i;
-                y = yval - (xmax / 2) + j;
-            }
+    auto x = this->wid;
+    auto y = this->hgt;
+    coord_trans(&x, &y, 0, 0, transno);
+    const auto yoffset = y < 0 ? -y - 1 : 0;
+    const auto xoffset = x < 0 ? -x - 1 : 0;
+    const auto is_swapped = (transno % 2) != 0;
+    const auto y_center = is_swapped ? this->wid / 2 : this->hgt / 2;
+    const auto x_center = is_swapped ? this->hgt / 2 : this->wid / 2;
+    layout.emplace();
+    layout->height = std::abs(y);
+    layout->width = std::abs(x);
+    for (auto dy = 0; dy < this->hgt; dy++) {
+        for (auto dx = 0; dx < this->wid; dx++) {
+            const auto index = static_cast<size_t>(dy * this->wid + dx);
+            const auto symbol = (index < this->text.size()) ? this->text[index] : ' ';
 
             /* Hack -- skip "non-grids" */
-            if (*t == ' ') {
+            if (symbol == ' ') {
                 continue;
             }
-            g_ptr = &floor_ptr->grid_array[y][x];
 
-            /* Lay down a floor */
-            place_grid(player_ptr, g_ptr, GB_FLOOR);
+            auto i = dx;
+            auto j = dy;
+            coord_trans(&i, &j, xoffset, yoffset, transno);
+            const VaultLayout::Cell cell{ j - y_center, i - x_center, symbol };
+            layout->cells.push_back(cell);
+            switch (symbol) {
+            case '&':
+            case '@':
+            case '9':
+            case '8':
+            case ',':
+                layout->spawns.push_back(cell);
+                break;
+            default:
+                break;
+            }
+        }
+    }
 
-            /* Remove any mimic */
-            g_ptr->mimic = 0;
+    return *layout;
+}
 
-            /* Part of a vault */
-            g_ptr->info |= (CAVE_ROOM | CAVE_ICKY);
+/*!
+ * @brief Vaultをフロアに配置する / Hack -- fill in "vault" rooms
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param yval 生成基準Y座標
+ * @param xval 生成基準X座標
+ * @param layout 回転・反転後のVaultの配置情報
+ */
+static void build_vault(PlayerType *player_ptr, POSITION yval, POSITION xval, const VaultLayout &layout)
+{
+    /* Place dungeon features and objects */
+    auto *floor_ptr = player_ptr->current_floor_ptr;
+    for (const auto &cell : layout.cells) {
+        const auto y = yval + cell.y;
+        const auto x = xval + cell.x;
+        auto *g_ptr = &floor_ptr->grid_array[y][x];
 
-            /* Analyze the grid */
-            switch (*t) {
-                /* Granite wall (outer) */
-            case '%':
-                place_grid(player_ptr, g_ptr, GB_OUTER_NOPERM);
-                break;
+        /* Lay down a floor */
+        place_grid(player_ptr, g_ptr, GB_FLOOR);
 
-                /* Granite wall (inner) */
-            case '#':
-                place_grid(player_ptr, g_ptr, GB_INNER);
-                break;
+        /* Remove any mimic */
+        g_ptr->mimic = 0;
 
-                /* Glass wall (inner) */
-            case '$':
-                place_grid(player_ptr, g_ptr, GB_INNER);
-                g_ptr->feat = feat_glass_wall;
-                break;
+        /* Part of a vault */
+        g_ptr->info |= (CAVE_ROOM | CAVE_ICKY);
 
-                /* Permanent wall (inner) */
-            case 'X':
-                place_grid(player_ptr, g_ptr, GB_INNER_PERM);
-                break;
+        /* Analyze the grid */
+        switch (cell.symbol) {
+            /* Granite wall (outer) */
+        case '%':
+            place_grid(player_ptr, g_ptr, GB_OUTER_NOPERM);
+            break;
 
-                /* Permanent glass wall (inner) */
-            case 'Y':
-                place_grid(player_ptr, g_ptr, GB_INNER_PERM);
-                g_ptr->feat = feat_permanent_glass_wall;
-                break;
+            /* Granite wall (inner) */
+        case '#':
+            place_grid(player_ptr, g_ptr, GB_INNER);
+            break;
 
-                /* Treasure/trap */
-            case '*':
-                if (evaluate_percent(75)) {
-                    place_object(player_ptr, y, x, 0L);
-                } else {
-                    place_trap(floor_ptr, y, x);
-                }
-                break;
+            /* Glass wall (inner) */
+        case '$':
+            place_grid(player_ptr, g_ptr, GB_INNER);
+            g_ptr->feat = feat_glass_wall;
+            break;
+
+            /* Permanent wall (inner) */
+        case 'X':
+            place_grid(player_ptr, g_ptr, GB_INNER_PERM);
+            break;
 
-                /* Treasure */
-            case '[':
+            /* Permanent glass wall (inner) */
+        case 'Y':
+            place_grid(player_ptr, g_ptr, GB_INNER_PERM);
+            g_ptr->feat = feat_permanent_glass_wall;
+            break;
+
+            /* Treasure/trap */
+        case '*':
+            if (evaluate_percent(75)) {
                 place_object(player_ptr, y, x, 0L);
-                break;
+            } else {
+                place_trap(floor_ptr, y, x);
+            }
+            break;
 
-                /* Tree */
-            case ':':
-                g_ptr->feat = feat_tree;
-                break;
+            /* Treasure */
+        case '[':
+            place_object(player_ptr, y, x, 0L);
+            break;
 
-                /* Secret doors */
-            case '+':
-                place_secret_door(player_ptr, y, x, DOOR_DEFAULT);
-                break;
+            /* Tree */
+        case ':':
+            g_ptr->feat = feat_tree;
+            break;
 
-                /* Secret glass doors */
-            case '-':
-                place_secret_door(player_ptr, y, x, DOOR_GLASS_DOOR);
-                if (is_closed_door(player_ptr, g_ptr->feat)) {
-                    g_ptr->mimic = feat_glass_wall;
-                }
-                break;
+            /* Secret doors */
+        case '+':
+            place_secret_door(player_ptr, y, x, DOOR_DEFAULT);
+            break;
 
-                /* Curtains */
-            case '\'':
-                place_secret_door(player_ptr, y, x, DOOR_CURTAIN);
-                break;
+            /* Secret glass doors */
+        case '-':
+            place_secret_door(player_ptr, y, x, DOOR_GLASS_DOOR);
+            if (is_closed_door(player_ptr, g_ptr->feat)) {
+                g_ptr->mimic = feat_glass_wall;
+            }
+            break;
 
-                /* Trap */
-            case '^':
-                place_trap(floor_ptr, y, x);
-                break;
+            /* Curtains */
+        case '\'':
+            place_secret_door(player_ptr, y, x, DOOR_CURTAIN);
+            break;
 
-                /* Black market in a dungeon */
-            case 'S':
-                set_cave_feat(floor_ptr, y, x, feat_black_market);
-                store_init(VALID_TOWNS, StoreSaleType::BLACK);
-                break;
+            /* Trap */
+        case '^':
+            place_trap(floor_ptr, y, x);
+            break;
 
-                /* The Pattern */
-            case 'p':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_start);
-                break;
+            /* Black market in a dungeon */
+        case 'S':
+            set_cave_feat(floor_ptr, y, x, feat_black_market);
+            store_init(VALID_TOWNS, StoreSaleType::BLACK);
+            break;
 
-            case 'a':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_1);
-                break;
+            /* The Pattern */
+        case 'p':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_start);
+            break;
 
-            case 'b':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_2);
-                break;
+        case 'a':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_1);
+            break;
 
-            case 'c':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_3);
-                break;
+        case 'b':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_2);
+            break;
 
-            case 'd':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_4);
-                break;
+        case 'c':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_3);
+            break;
 
-            case 'P':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_end);
-                break;
+        case 'd':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_4);
+            break;
 
-            case 'B':
-                set_cave_feat(floor_ptr, y, x, feat_pattern_exit);
-                break;
+        case 'P':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_end);
+            break;
 
-            case 'A':
-                /* Reward for Pattern walk */
-                floor_ptr->object_level = floor_ptr->base_level + 12;
-                place_object(player_ptr, y, x, AM_GOOD | AM_GREAT);
-                floor_ptr->object_level = floor_ptr->base_level;
-                break;
+        case 'B':
+            set_cave_feat(floor_ptr, y, x, feat_pattern_exit);
+            break;
 
-            case '~':
-                set_cave_feat(floor_ptr, y, x, feat_shallow_water);
-                break;
+        case 'A':
+            /* Reward for Pattern walk */
+            floor_ptr->object_level = floor_ptr->base_level + 12;
+            place_object(player_ptr, y, x, AM_GOOD | AM_GREAT);
+            floor_ptr->object_level = floor_ptr->base_level;
+            break;
 
-            case '=':
-                set_cave_feat(floor_ptr, y, x, feat_deep_water);
-                break;
+        case '~':
+            set_cave_feat(floor_ptr, y, x, feat_shallow_water);
+            break;
 
-            case 'v':
-                set_cave_feat(floor_ptr, y, x, feat_shallow_lava);
-                break;
+        case '=':
+            set_cave_feat(floor_ptr, y, x, feat_deep_water);
+            break;
 
-            case 'w':
-                set_cave_feat(floor_ptr, y, x, feat_deep_lava);
-                break;
+        case 'v':
+            set_cave_feat(floor_ptr, y, x, feat_shallow_lava);
+            break;
 
-            case 'f':
-                set_cave_feat(floor_ptr, y, x, feat_shallow_acid_puddle);
-                break;
+        case 'w':
+            set_cave_feat(floor_ptr, y, x, feat_deep_lava);
+            break;
 
-            case 'F':
-                set_cave_feat(floor_ptr, y, x, feat_deep_acid_puddle);
-                break;
+        case 'f':
+            set_cave_feat(floor_ptr, y, x, feat_shallow_acid_puddle);
+            break;
 
-            case 'g':
-                set_cave_feat(floor_ptr, y, x, feat_shallow_poisonous_puddle);
-                break;
+        case 'F':
+            set_cave_feat(floor_ptr, y, x, feat_deep_acid_puddle);
+            break;
 
-            case 'G':
-                set_cave_feat(floor_ptr, y, x, feat_deep_poisonous_puddle);
-                break;
+        case 'g':
+            set_cave_feat(floor_ptr, y, x, feat_shallow_poisonous_puddle);
+            break;
 
-            case 'h':
-                set_cave_feat(floor_ptr, y, x, feat_cold_zone);
-                break;
+        case 'G':
+            set_cave_feat(floor_ptr, y, x, feat_deep_poisonous_puddle);
+            break;
 
-            case 'H':
-                set_cave_feat(floor_ptr, y, x, feat_heavy_cold_zone);
-                break;
+        case 'h':
+            set_cave_feat(floor_ptr, y, x, feat_cold_zone);
+            break;
 
-            case 'i':
-                set_cave_feat(floor_ptr, y, x, feat_electrical_zone);
-                break;
+        case 'H':
+            set_cave_feat(floor_ptr, y, x, feat_heavy_cold_zone);
+            break;
 
-            case 'I':
-                set_cave_feat(floor_ptr, y, x, feat_heavy_electrical_zone);
-                break;
-            }
+        case 'i':
+            set_cave_feat(floor_ptr, y, x, feat_electrical_zone);
+            break;
+
+        case 'I':
+            set_cave_feat(floor_ptr, y, x, feat_heavy_electrical_zone);
+            break;
         }
     }
 
     /* Place dungeon monsters and objects */
-    for (t = data, dy = 0; dy < ymax; dy++) {
-        for (dx = 0; dx < xmax; dx++, t++) {
-            /* prevent loop counter from being overwritten */
-            i = dx;
-            j = dy;
-
-            /* Flip / rotate */
-            coord_trans(&i, &j, xoffset, yoffset, transno);
+    for (const auto &cell : layout.spawns) {
+        const auto y = yval + cell.y;
+        const auto x = xval + cell.x;
+
+        /* Analyze the symbol */
+        switch (cell.symbol) {
+        case '&': {
+            floor_ptr->monster_level = floor_ptr->base_level + 5;
+            place_random_monster(player_ptr, y, x, (PM_ALLOW_SLEEP | PM_ALLOW_GROUP));
+            floor_ptr->monster_level = floor_ptr->base_level;
+            break;
+        }
 
-            if (transno % 2 == 0) {
-                /* no swap of x/y */
-                x = xval - (xmax / 2) + i;
-                y = yval - (ymax / 2) + j;
-            } else {
-                /* swap of x/y */
-                x = xval - (ymax / 2) + i;
-                y = yval - (xmax / 2) + j;
-            }
+        /* Meaner monster */
+        case '@': {
+            floor_ptr->monster_level = floor_ptr->base_level + 11;
+            place_random_monster(player_ptr, y, x, (PM_ALLOW_SLEEP | PM_ALLOW_GROUP));
+            floor_ptr->monster_level = floor_ptr->base_level;
+            break;
+        }
 
-            /* Hack -- skip "non-grids" */
-            if (*t == ' ') {
-                continue;
-            }
+        /* Meaner monster, plus treasure */
+        case '9': {
+            floor_ptr->monster_level = floor_ptr->base_level + 9;
+            place_random_monster(player_ptr, y, x, PM_ALLOW_SLEEP);
+            floor_ptr->monster_level = floor_ptr->base_level;
+            floor_ptr->object_level = floor_ptr->base_level + 7;
+            place_object(player_ptr, y, x, AM_GOOD);
+            floor_ptr->object_level = floor_ptr->base_level;
+            break;
+        }
 
-            /* Analyze the symbol */
-            switch (*t) {
-            case '&': {
-                floor_ptr->monster_level = floor_ptr->base_level + 5;
-                place_random_monster(player_ptr, y, x, (PM_ALLOW_SLEEP | PM_ALLOW_GROUP));
-                floor_ptr->monster_level = floor_ptr->base_level;
-                break;
-            }
+        /* Nasty monster and treasure */
+        case '8': {
+            floor_ptr->monster_level = floor_ptr->base_level + 40;
+            place_random_monster(player_ptr, y, x, PM_ALLOW_SLEEP);
+            floor_ptr->monster_level = floor_ptr->base_level;
+            floor_ptr->object_level = floor_ptr->base_level + 20;
+            place_object(player_ptr, y, x, AM_GOOD | AM_GREAT);
+            floor_ptr->object_level = floor_ptr->base_level;
+            break;
+        }
 
-            /* Meaner monster */
-            case '@': {
-                floor_ptr->monster_level = floor_ptr->base_level + 11;
+        /* Monster and/or object */
+        case ',': {
+            if (one_in_(2)) {
+                floor_ptr->monster_level = floor_ptr->base_level + 3;
                 place_random_monster(player_ptr, y, x, (PM_ALLOW_SLEEP | PM_ALLOW_GROUP));
                 floor_ptr->monster_level = floor_ptr->base_level;
-                break;
             }
-
-            /* Meaner monster, plus treasure */
-            case '9': {
-                floor_ptr->monster_level = floor_ptr->base_level + 9;
-                place_random_monster(player_ptr, y, x, PM_ALLOW_SLEEP);
-                floor_ptr->monster_level = floor_ptr->base_level;
+            if (one_in_(2)) {
                 floor_ptr->object_level = floor_ptr->base_level + 7;
-                place_object(player_ptr, y, x, AM_GOOD);
-                floor_ptr->object_level = floor_ptr->base_level;
-                break;
-            }
-
-            /* Nasty monster and treasure */
-            case '8': {
-                floor_ptr->monster_level = floor_ptr->base_level + 40;
-                place_random_monster(player_ptr, y, x, PM_ALLOW_SLEEP);
-                floor_ptr->monster_level = floor_ptr->base_level;
-                floor_ptr->object_level = floor_ptr->base_level + 20;
-                place_object(player_ptr, y, x, AM_GOOD | AM_GREAT);
+                place_object(player_ptr, y, x, 0L);
                 floor_ptr->object_level = floor_ptr->base_level;
-                break;
-            }
-
-            /* Monster and/or object */
-            case ',': {
-                if (one_in_(2)) {
-                    floor_ptr->monster_level = floor_ptr->base_level + 3;
-                    place_random_monster(player_ptr, y, x, (PM_ALLOW_SLEEP | PM_ALLOW_GROUP));
-                    floor_ptr->monster_level = floor_ptr->base_level;
-                }
-                if (one_in_(2)) {
-                    floor_ptr->object_level = floor_ptr->base_level + 7;
-                    place_object(player_ptr, y, x, 0L);
-                    floor_ptr->object_level = floor_ptr->base_level;
-                }
-                break;
-            }
             }
+            break;
+        }
         }
     }
 }
@@ -1009,20 +1014,14 @@ bool build_fixed_room(PlayerType *player_ptr, dun_data_type *dd_ptr, int typ, bo
     const auto &vault = vaults_info[result];
     auto num_transformation = randint0(8);
 
-    /* calculate offsets */
-    auto x = vault.wid;
-    auto y = vault.hgt;
-
     /* Some huge vault cannot be ratated to fit in the dungeon */
     const auto &floor = *player_ptr->current_floor_ptr;
-    if (x + 2 > floor.height - 2) {
+    if (vault.wid + 2 > floor.height - 2) {
         /* Forbid 90 or 270 degree ratation */
         num_transformation &= ~1;
     }
 
-    coord_trans(&x, &y, 0, 0, num_transformation);
-    const auto y_offset = y < 0 ? -y - 1 : 0;
-    const auto x_offset = x < 0 ? -x - 1 : 0;
+    const auto &layout = vault.get_layout(num_transformation);
 
     /*
      * Try to allocate space for room.  If fails, exit
@@ -1030,8 +1029,8 @@ bool build_fixed_room(PlayerType *player_ptr, dun_data_type *dd_ptr, int typ, bo
      * Hack -- Prepare a bit larger space (+2, +2) to
      * prevent generation of vaults with no-entrance.
      */
-    const auto xsize = more_space ? std::abs(x) + 2 : std::abs(x);
-    const auto ysize = more_space ? std::abs(y) + 2 : std::abs(y);
+    const auto xsize = more_space ? layout.width + 2 : layout.width;
+    const auto ysize = more_space ? layout.height + 2 : layout.height;
     /* Find and reserve some space in the dungeon.  Get center of room. */
     int yval;
     int xval;
@@ -1040,6 +1039,7 @@ bool build_fixed_room(PlayerType *player_ptr, dun_data_type *dd_ptr, int typ, bo
     }
 
     msg_format_wizard(player_ptr, CHEAT_DUNGEON, _("固定部屋(%s)を生成しました。", "Fixed room (%s)."), vault.name.data());
-    build_vault(player_ptr, yval, xval, vault.hgt, vault.wid, vault.text.data(), x_offset, y_offset, num_transformation);
+    FloorGenerationStatistics::get_instance().add_vault(vault.name);
+    build_vault(player_ptr, yval, xval, layout);
     return true;
 }
@@ -1,9 +1,30 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
+/*!
+ * @brief 向きを決めたVaultの配置情報
+ */
+struct VaultLayout {
+    /*!
+     * @brief Vaultの1マス
+     */
+    struct Cell {
+        int y; //!< 部屋の中心からのY方向の位置
+        int x; //!< 部屋の中心からのX方向の位置
+        char symbol; //!< 定義文字
+    };
+
+    int height = 0; //!< 回転後の高さ
+    int width = 0; //!< 回転後の幅
+    std::vector<Cell> cells; //!< 空白以外の全マス (定義文字列の順)
+    std::vector<Cell> spawns; //!< モンスターやアイテムを置くマス (定義文字列の順)
+};
+
 struct vault_type {
     vault_type() = default;
     short idx = 0;
@@ -15,6 +36,11 @@ struct vault_type {
     int rat = 0; /* Vault rating (unused) */
     int hgt = 0; /* Vault height */
     int wid = 0; /* Vault width */
+
+    const VaultLayout &get_layout(int transno) const;
+
+private:
+    mutable std::array<std::optional<VaultLayout>, 8> layouts; //!< 回転・反転の種類毎の配置情報
 };
 
 extern std::vector<vault_type> vaults_info;
@@ -7,6 +7,8 @@
 #include "system/floor-type-definition.h"
 #include "system/grid-type-definition.h"
 #include "system/player-type-definition.h"
+#include <array>
+#include <vector>
 
 /*!
  * @brief 指定のマスが床系地形であるかを返す
@@ -107,14 +109,65 @@ static void check_room_boundary(PlayerType *player_ptr, const Pos2D &pos1, const
     }
 }
 
+namespace {
 /*!
- * @brief find_space()の予備処理として部屋の生成が可能かを判定する
- * @param blocks_high 範囲の高さ
- * @param blocks_wide 範囲の幅
- * @param block_y 範囲の上端
- * @param block_x 範囲の左端
+ * @brief 部屋用ブロックの使用状況を矩形単位で問い合わせるための累積和テーブル
+ * @details sums[y][x] は room_map の [0, y) x [0, x) の範囲にある使用済みブロック数を表す.
  */
-static bool find_space_aux(dun_data_type *dd_ptr, const Pos2D &max_block_size, const Pos2D &block)
+class RoomBlockOccupancy {
+public:
+    RoomBlockOccupancy(const dun_data_type &dd);
+    bool is_free(const Pos2D &block, const Pos2D &size) const;
+
+private:
+    int row_rooms;
+    int col_rooms;
+    std::array<std::array<int, MAX_ROOMS_COL + 1>, MAX_ROOMS_ROW + 1> sums{};
+};
+
+/*!
+ * @brief コンストラクタ
+ * @param dd ダンジョン生成データ
+ */
+RoomBlockOccupancy::RoomBlockOccupancy(const dun_data_type &dd)
+    : row_rooms(dd.row_rooms)
+    , col_rooms(dd.col_rooms)
+{
+    for (auto by = 0; by < this->row_rooms; by++) {
+        for (auto bx = 0; bx < this->col_rooms; bx++) {
+            const auto used = dd.room_map[by][bx] ? 1 : 0;
+            this->sums[by + 1][bx + 1] = used + this->sums[by][bx + 1] + this->sums[by + 1][bx] - this->sums[by][bx];
+        }
+    }
+}
+
+/*!
+ * @brief 指定範囲のブロックが全て未使用かを返す
+ * @param block 範囲の左上端
+ * @param size 範囲の高さと幅
+ * @return 範囲がダンジョン内に収まり、全て未使用ならばtrue
+ */
+bool RoomBlockOccupancy::is_free(const Pos2D &block, const Pos2D &size) const
+{
+    const auto by1 = block.y;
+    const auto bx1 = block.x;
+    const auto by2 = block.y + size.y;
+    const auto bx2 = block.x + size.x;
+    if ((by1 < 0) || (by2 > this->row_rooms) || (bx1 < 0) || (bx2 > this->col_rooms)) {
+        return false;
+    }
+
+    return (this->sums[by2][bx2] - this->sums[by1][bx2] - this->sums[by2][bx1] + this->sums[by1][bx1]) == 0;
+}
+}
+
+/*!
+ * @brief 部屋の左端が画面上の揃え位置に合っているかを判定する
+ * @param dd_ptr ダンジョン生成データへの参照ポインタ
+ * @param max_block_size 範囲の高さと幅
+ * @param block 範囲の左上端
+ */
+static bool is_aligned_block(dun_data_type *dd_ptr, const Pos2D &max_block_size, const Pos2D &block)
 {
     if (max_block_size.x < 3) {
         if ((max_block_size.x == 2) && (block.x % 3) == 2) {
@@ -142,22 +195,6 @@ static bool find_space_aux(dun_data_type *dd_ptr, const Pos2D &max_block_size, c
         }
     }
 
-    const auto by1 = block.y;
-    const auto bx1 = block.x;
-    const auto by2 = block.y + max_block_size.y;
-    const auto bx2 = block.x + max_block_size.x;
-    if ((by1 < 0) || (by2 > dd_ptr->row_rooms) || (bx1 < 0) || (bx2 > dd_ptr->col_rooms)) {
-        return false;
-    }
-
-    for (auto by = by1; by < by2; by++) {
-        for (auto bx = bx1; bx < bx2; bx++) {
-            if (dd_ptr->room_map[by][bx]) {
-                return false;
-            }
-        }
-    }
-
     return true;
 }
 
@@ -184,7 +221,6 @@ static bool find_space_aux(dun_data_type *dd_ptr, const Pos2D &max_block_size, c
  */
 bool find_space(PlayerType *player_ptr, dun_data_type *dd_ptr, POSITION *y, POSITION *x, POSITION height, POSITION width)
 {
-    int pick;
     POSITION block_y = 0;
     POSITION block_x = 0;
     POSITION blocks_high = 1 + ((height - 1) / BLOCK_HGT);
@@ -193,41 +229,32 @@ bool find_space(PlayerType *player_ptr, dun_data_type *dd_ptr, POSITION *y, POSI
         return false;
     }
 
-    int candidates = 0;
+    /* 配置可能な位置を全て列挙し、その中から選ぶ */
+    const RoomBlockOccupancy occupancy(*dd_ptr);
+    std::vector<Pos2D> candidates;
     for (block_y = dd_ptr->row_rooms - blocks_high; block_y >= 0; block_y--) {
         for (block_x = dd_ptr->col_rooms - blocks_wide; block_x >= 0; block_x--) {
-            if (find_space_aux(dd_ptr, { blocks_high, blocks_wide }, { block_y, block_x })) {
-                /* Find a valid place */
-                candidates++;
+            const Pos2D block(block_y, block_x);
+            if (is_aligned_block(dd_ptr, { blocks_high, blocks_wide }, block) && occupancy.is_free(block, { blocks_high, blocks_wide })) {
+                candidates.push_back(block);
             }
         }
     }
 
-    if (!candidates) {
+    if (candidates.empty()) {
         return false;
     }
 
+    int pick;
+    const auto num_candidates = static_cast<int>(candidates.size());
     if (player_ptr->current_floor_ptr->get_dungeon_definition().flags.has_not(DungeonFeatureType::NO_CAVE)) {
-        pick = randint1(candidates);
+        pick = randint1(num_candidates);
     } else {
-        pick = candidates / 2 + 1;
-    }
-
-    for (block_y = dd_ptr->row_rooms - blocks_high; block_y >= 0; block_y--) {
-        for (block_x = dd_ptr->col_rooms - blocks_wide; block_x >= 0; block_x--) {
-            if (find_space_aux(dd_ptr, { blocks_high, blocks_wide }, { block_y, block_x })) {
-                pick--;
-                if (!pick) {
-                    break;
-                }
-            }
-        }
-
-        if (!pick) {
-            break;
-        }
+        pick = num_candidates / 2 + 1;
     }
 
+    block_y = candidates[pick - 1].y;
+    block_x = candidates[pick - 1].x;
     POSITION by1 = block_y;
     POSITION bx1 = block_x;
     POSITION by2 = block_y + blocks_high;
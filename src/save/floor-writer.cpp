@@ -228,6 +228,7 @@ static bool save_floor_aux(PlayerType *player_ptr, saved_floor_type *sf_ptr)
     compact_monsters(player_ptr, 0);
 
     byte tmp8u = (byte)randint0(256);
+    saving_savedata.clear();
     save_xor_byte = 0;
     wr_byte(tmp8u);
 
@@ -239,7 +240,7 @@ static bool save_floor_aux(PlayerType *player_ptr, saved_floor_type *sf_ptr)
     wr_u32b(v_stamp);
     wr_u32b(x_stamp);
 
-    return !ferror(saving_savefile) && (fflush(saving_savefile) != EOF);
+    return flush_savefile();
 }
 /*!
  * @brief ゲームプレイ中のフロア一時保存出力処理メインルーチン / Attempt to save the temporarily saved-floor data
@@ -250,12 +251,14 @@ static bool save_floor_aux(PlayerType *player_ptr, saved_floor_type *sf_ptr)
 bool save_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode)
 {
     FILE *old_fff = nullptr;
+    std::vector<byte> old_savedata;
     byte old_xor_byte = 0;
     uint32_t old_v_stamp = 0;
     uint32_t old_x_stamp = 0;
 
     if ((mode & SLF_SECOND) != 0) {
         old_fff = saving_savefile;
+        old_savedata = std::move(saving_savedata);
         old_xor_byte = save_xor_byte;
         old_v_stamp = v_stamp;
         old_x_stamp = x_stamp;
@@ -297,6 +300,7 @@ bool save_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode
 
     if ((mode & SLF_SECOND) != 0) {
         saving_savefile = old_fff;
+        saving_savedata = std::move(old_savedata);
         save_xor_byte = old_xor_byte;
         v_stamp = old_v_stamp;
         x_stamp = old_x_stamp;
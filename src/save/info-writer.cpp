@@ -36,16 +36,27 @@ void wr_store(store_type *store_ptr)
 /*!
  * @brief セーブデータに乱数情報を書き込む / Write RNG state
  * @param なし
+ * @details ゲームの乱数に続いて、旧形式では未使用だった領域に用途毎の乱数列を書き込む.
  */
 void wr_randomizer(void)
 {
     wr_u16b(0);
     wr_u16b(0);
-    const auto &state = AngbandSystem::get_instance().get_rng().get_state();
-    for (const auto s : state) {
+    auto &system = AngbandSystem::get_instance();
+    auto written = 0;
+    for (const auto s : system.get_rng().get_state()) {
         wr_u32b(s);
+        written++;
     }
-    for (int i = state.size(); i < RAND_DEG; i++) {
+
+    for (auto stream = 0; stream < enum2i(RngStream::MAX); stream++) {
+        for (const auto s : system.get_rng_stream(i2enum<RngStream>(stream)).get_state()) {
+            wr_u32b(s);
+            written++;
+        }
+    }
+
+    for (auto i = written; i < RAND_DEG; i++) {
         wr_u32b(0);
     }
 }
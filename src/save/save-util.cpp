@@ -1,6 +1,12 @@
 #include "save/save-util.h"
+#include "game-option/game-play-options.h"
+#include "system/angband-version.h"
+#include "util/lz-compressor.h"
 
 FILE *saving_savefile; /* Current save "file" */
+std::vector<byte> saving_savedata; /* Encoded bytes waiting to be written */
+
+static std::vector<byte> *saving_section_plain = nullptr; /* Plain bytes of the section being captured */
 byte save_xor_byte; /* Simple encryption */
 uint32_t v_stamp = 0L; /* A simple "checksum" on the actual values */
 uint32_t x_stamp = 0L; /* A simple "checksum" on the encoded bytes */
@@ -11,9 +17,14 @@ uint32_t x_stamp = 0L; /* A simple "checksum" on the encoded bytes */
  */
 static void sf_put(byte v)
 {
+    if (saving_section_plain) {
+        saving_section_plain->push_back(v);
+        return;
+    }
+
     /* Encode the value, write a character */
     save_xor_byte ^= v;
-    (void)putc((int)save_xor_byte, saving_savefile);
+    saving_savedata.push_back(save_xor_byte);
 
     /* Maintain the checksum info */
     v_stamp += v;
@@ -89,3 +100,121 @@ void wr_string(std::string_view sv)
     }
     wr_byte('\0');
 }
+
+/*!
+ * @brief 平文をXORバイト0から始めてエンコードし、チェックサムへの寄与分と共に保持する
+ * @param plain_bytes 区画の平文
+ */
+SavedataSection::Encoding::Encoding(std::vector<byte> &&plain_bytes)
+    : plain_bytes(std::move(plain_bytes))
+{
+    this->encoded_bytes.resize(this->plain_bytes.size());
+    byte xor_byte = 0;
+    for (size_t i = 0; i < this->plain_bytes.size(); i++) {
+        const auto v = this->plain_bytes[i];
+        xor_byte ^= v;
+        this->encoded_bytes[i] = xor_byte;
+        this->v_sum += v;
+        this->x_sum += xor_byte;
+    }
+}
+
+/*!
+ * @brief 区画を書き込む
+ * @param writer 区画の中身を wr_*() で書き込む関数
+ * @details
+ * 区画の先頭には区画のバイト数を書き込む. 読み込み側は区画の先頭でXORバイトを0に戻すこと.
+ * writer による書き込みは一旦平文のまま取り込み、前回セーブに成功した時と中身が異なる時だけエンコードし直す.
+ * エンコードし直した結果は、セーブの成否が分かってから commit() か discard() で扱いを決める.
+ */
+void SavedataSection::write(const std::function<void()> &writer)
+{
+    std::vector<byte> plain;
+    plain.reserve(this->saved ? this->saved->plain_bytes.size() : 0);
+    saving_section_plain = &plain;
+    writer();
+    saving_section_plain = nullptr;
+    this->pending.reset();
+    if (!this->saved || (plain != this->saved->plain_bytes)) {
+        this->pending.emplace(std::move(plain));
+    }
+
+    const auto &encoding = this->pending ? *this->pending : *this->saved;
+    wr_u32b(static_cast<uint32_t>(encoding.encoded_bytes.size()));
+    saving_savedata.insert(saving_savedata.end(), encoding.encoded_bytes.begin(), encoding.encoded_bytes.end());
+    v_stamp += encoding.v_sum;
+    x_stamp += encoding.x_sum;
+    if (!encoding.encoded_bytes.empty()) {
+        save_xor_byte = encoding.encoded_bytes.back();
+    }
+}
+
+/*!
+ * @brief セーブに成功したので、今回書き込んだ中身を次回のセーブで再利用する
+ */
+void SavedataSection::commit()
+{
+    if (this->pending) {
+        this->saved = std::move(this->pending);
+        this->pending.reset();
+    }
+}
+
+/*!
+ * @brief セーブに失敗したので、今回エンコードし直した結果を捨てる
+ */
+void SavedataSection::discard()
+{
+    this->pending.reset();
+}
+
+/*!
+ * @brief 符号なし32ビットをリトルエンディアンでファイルに直接書き込む
+ * @param v 書き込む符号なし32bit値
+ */
+static void put_u32b_raw(uint32_t v)
+{
+    for (auto i = 0; i < 4; i++) {
+        (void)putc((v >> (i * 8)) & 0xFF, saving_savefile);
+    }
+}
+
+/*!
+ * @brief 書き込み待ちのデータを圧縮コンテナ形式でファイルに書き込む
+ * @details
+ * エンコード済みバイト列は直前のバイトとのXORを取り直してから圧縮する.
+ * こうすると大半のバイトが元の値に戻り、圧縮が効きやすくなる.
+ */
+static void write_savefile_container()
+{
+    std::vector<byte> filtered(saving_savedata.size());
+    byte prev = 0;
+    for (size_t i = 0; i < saving_savedata.size(); i++) {
+        filtered[i] = saving_savedata[i] ^ prev;
+        prev = saving_savedata[i];
+    }
+
+    const auto compressed = util::lz_compress(filtered);
+    (void)fwrite(SAVEFILE_CONTAINER_MAGIC.data(), 1, SAVEFILE_CONTAINER_MAGIC.length(), saving_savefile);
+    (void)putc(SAVEFILE_CONTAINER_VERSION, saving_savefile);
+    put_u32b_raw(static_cast<uint32_t>(saving_savedata.size()));
+    put_u32b_raw(static_cast<uint32_t>(compressed.size()));
+    (void)fwrite(compressed.data(), 1, compressed.size(), saving_savefile);
+}
+
+/*!
+ * @brief 書き込み待ちのデータをファイルに書き出す
+ * @return 書き込みに成功したか否か
+ * @details compress_savedata オプションが有効なら圧縮コンテナ形式で書き出す.
+ */
+bool flush_savefile()
+{
+    if (compress_savedata) {
+        write_savefile_container();
+    } else {
+        (void)fwrite(saving_savedata.data(), 1, saving_savedata.size(), saving_savefile);
+    }
+
+    saving_savedata.clear();
+    return !ferror(saving_savefile) && (fflush(saving_savefile) != EOF);
+}
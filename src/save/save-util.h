@@ -1,13 +1,51 @@
 #pragma once
 
 #include "system/angband.h"
+#include <functional>
+#include <optional>
 #include <string_view>
+#include <vector>
 
 extern FILE *saving_savefile;
+extern std::vector<byte> saving_savedata;
 extern byte save_xor_byte;
 extern uint32_t v_stamp;
 extern uint32_t x_stamp;
 
+/*!
+ * @brief 1区画に格納するレコード数
+ */
+constexpr auto SAVEDATA_SECTION_RECORDS = 64;
+
+/*!
+ * @brief 独立して読み書きできるセーブデータの区画
+ * @details
+ * 区画の先頭でXORバイトをリセットするため、エンコード結果は区画の中身だけで決まる.
+ * 中身が前回セーブに成功した時と同じであれば、エンコードし直さずにその時の結果を再利用する.
+ */
+class SavedataSection {
+public:
+    void write(const std::function<void()> &writer);
+    void commit();
+    void discard();
+
+private:
+    /*!
+     * @brief 区画の平文とエンコード結果
+     */
+    struct Encoding {
+        std::vector<byte> plain_bytes; //!< 平文
+        std::vector<byte> encoded_bytes; //!< エンコード済みのバイト列
+        uint32_t v_sum = 0; //!< 平文のチェックサムへの寄与分
+        uint32_t x_sum = 0; //!< エンコード済みバイト列のチェックサムへの寄与分
+
+        explicit Encoding(std::vector<byte> &&plain_bytes);
+    };
+
+    std::optional<Encoding> saved; //!< 前回セーブに成功した時の中身
+    std::optional<Encoding> pending; //!< セーブ中のファイルに書き込んだ、前回と異なる中身
+};
+
 void wr_bool(bool v);
 void wr_byte(byte v);
 void wr_u16b(uint16_t v);
@@ -15,3 +53,4 @@ void wr_s16b(int16_t v);
 void wr_u32b(uint32_t v);
 void wr_s32b(int32_t v);
 void wr_string(std::string_view sv);
+bool flush_savefile();
@@ -46,6 +46,68 @@
 #include <sstream>
 #include <string>
 
+static std::vector<SavedataSection> lore_sections; /* モンスターの思い出の区画 */
+static std::vector<SavedataSection> perception_sections; /* ベースアイテムの鑑定情報の区画 */
+
+/*!
+ * @brief モンスターの思い出を区画に分けて書き込む
+ * @details 前回のセーブから変化のない区画は、前回のエンコード結果を再利用する.
+ */
+static void wr_lore_sections()
+{
+    auto &sections = lore_sections;
+    const auto monraces_size = static_cast<uint16_t>(monraces_info.size());
+    wr_u16b(monraces_size);
+    wr_u16b(SAVEDATA_SECTION_RECORDS);
+    sections.resize((monraces_size + SAVEDATA_SECTION_RECORDS - 1) / SAVEDATA_SECTION_RECORDS);
+    for (auto i = 0U; i < sections.size(); i++) {
+        sections[i].write([i, monraces_size] {
+            const auto end = std::min<int>((i + 1) * SAVEDATA_SECTION_RECORDS, monraces_size);
+            for (int r_idx = i * SAVEDATA_SECTION_RECORDS; r_idx < end; r_idx++) {
+                wr_lore(i2enum<MonsterRaceId>(r_idx));
+            }
+        });
+    }
+}
+
+/*!
+ * @brief ベースアイテムの鑑定情報を区画に分けて書き込む
+ * @details 前回のセーブから変化のない区画は、前回のエンコード結果を再利用する.
+ */
+static void wr_perception_sections()
+{
+    auto &sections = perception_sections;
+    const auto baseitems_size = static_cast<uint16_t>(BaseitemList::get_instance().size());
+    wr_u16b(baseitems_size);
+    wr_u16b(SAVEDATA_SECTION_RECORDS);
+    sections.resize((baseitems_size + SAVEDATA_SECTION_RECORDS - 1) / SAVEDATA_SECTION_RECORDS);
+    for (auto i = 0U; i < sections.size(); i++) {
+        sections[i].write([i, baseitems_size] {
+            const auto end = std::min<int>((i + 1) * SAVEDATA_SECTION_RECORDS, baseitems_size);
+            for (int bi_id = i * SAVEDATA_SECTION_RECORDS; bi_id < end; bi_id++) {
+                wr_perception(static_cast<short>(bi_id));
+            }
+        });
+    }
+}
+
+/*!
+ * @brief セーブの成否に応じて、今回エンコードし直した区画を次回のセーブで再利用するか捨てるかを決める
+ * @param is_successful セーブに成功したか
+ */
+static void finish_savedata_sections(bool is_successful)
+{
+    for (auto *sections : { &lore_sections, &perception_sections }) {
+        for (auto &section : *sections) {
+            if (is_successful) {
+                section.commit();
+            } else {
+                section.discard();
+            }
+        }
+    }
+}
+
 /*!
  * @brief セーブデータの書き込み /
  * Actually write a save-file
@@ -63,6 +125,7 @@ static bool wr_savefile_new(PlayerType *player_ptr)
     world.sf_when = now;
     world.sf_saves++;
 
+    saving_savedata.clear();
     save_xor_byte = 0;
     auto variant_length = VARIANT_NAME.length();
     wr_byte(static_cast<byte>(variant_length));
@@ -106,19 +169,10 @@ static bool wr_savefile_new(PlayerType *player_ptr)
     wr_options();
     wr_message_history();
 
-    uint16_t tmp16u = static_cast<uint16_t>(monraces_info.size());
-    wr_u16b(tmp16u);
-    for (auto r_idx = 0; r_idx < tmp16u; r_idx++) {
-        wr_lore(i2enum<MonsterRaceId>(r_idx));
-    }
+    wr_lore_sections();
+    wr_perception_sections();
 
-    tmp16u = static_cast<uint16_t>(BaseitemList::get_instance().size());
-    wr_u16b(tmp16u);
-    for (short bi_id = 0; bi_id < tmp16u; bi_id++) {
-        wr_perception(bi_id);
-    }
-
-    tmp16u = static_cast<uint16_t>(towns_info.size());
+    auto tmp16u = static_cast<uint16_t>(towns_info.size());
     wr_u16b(tmp16u);
 
     const auto &quests = QuestList::get_instance();
@@ -239,7 +293,7 @@ static bool wr_savefile_new(PlayerType *player_ptr)
 
     wr_u32b(v_stamp);
     wr_u32b(x_stamp);
-    return !ferror(saving_savefile) && (fflush(saving_savefile) != EOF);
+    return flush_savefile();
 }
 
 /*!
@@ -272,6 +326,7 @@ static bool save_player_aux(PlayerType *player_ptr, const std::filesystem::path
             }
         }
 
+        finish_savedata_sections(is_save_successful);
         safe_setuid_grab();
         if (!is_save_successful) {
             (void)fd_kill(path);
@@ -47,16 +47,48 @@ void AngbandSystem::set_seed_town(const uint32_t seed)
     this->seed_town = seed;
 }
 
+/*!
+ * @brief 現在使用している乱数を取得する
+ * @return RngStreamGuard で切り替えられていればその乱数、そうでなければゲームの乱数
+ */
 Xoshiro128StarStar &AngbandSystem::get_rng()
 {
-    return this->rng;
+    return *this->current_rng;
 }
 
+/*!
+ * @brief ゲームの乱数を設定する
+ * @param rng_ 設定する乱数
+ * @details 用途毎の乱数列は変わらないため、必要であれば derive_rng_streams() を併せて呼ぶこと.
+ */
 void AngbandSystem::set_rng(const Xoshiro128StarStar &rng_)
 {
     this->rng = rng_;
 }
 
+/*!
+ * @brief 用途毎の乱数列を取得する
+ * @param stream 乱数列の種別
+ * @return 乱数列への参照
+ */
+Xoshiro128StarStar &AngbandSystem::get_rng_stream(RngStream stream)
+{
+    return this->rng_streams.at(enum2i(stream));
+}
+
+/*!
+ * @brief ゲームの乱数から用途毎の乱数列を導出する
+ * @details ゲームの乱数を2^64回ずつジャンプさせた状態を順に割り当てるため、各乱数列は互いに重ならない.
+ */
+void AngbandSystem::derive_rng_streams()
+{
+    auto rng_jumped = this->rng;
+    for (auto &rng_stream : this->rng_streams) {
+        rng_jumped.jump();
+        rng_stream = rng_jumped;
+    }
+}
+
 AngbandVersion &AngbandSystem::get_version()
 {
     return this->version;
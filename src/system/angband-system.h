@@ -1,11 +1,25 @@
 #pragma once
 
 #include "system/angband-version.h"
+#include "util/enum-converter.h"
 #include "util/rng-xoshiro.h"
+#include <array>
 #include <cstdint>
 #include <string>
 #include <string_view>
 
+/*!
+ * @brief 用途毎に独立した乱数列の種別
+ * @details 全てゲームの乱数からジャンプ関数で導出され、互いに重ならない.
+ */
+enum class RngStream : int {
+    FLOOR_GENERATION = 0, //!< フロア生成
+    ITEM_GENERATION = 1, //!< アイテム生成
+    MONSTER_AI = 2, //!< モンスターの行動
+    COSMETIC = 3, //!< 画面表示のみに影響する演出 (幻覚時のシンボル等)
+    MAX,
+};
+
 class AngbandSystem {
 public:
     AngbandSystem(const AngbandSystem &) = delete;
@@ -25,17 +39,24 @@ public:
     void set_seed_town(const uint32_t seed);
     Xoshiro128StarStar &get_rng();
     void set_rng(const Xoshiro128StarStar &rng_);
+    Xoshiro128StarStar &get_rng_stream(RngStream stream);
+    void derive_rng_streams();
     AngbandVersion &get_version();
     const AngbandVersion &get_version() const;
     void set_version(const AngbandVersion &new_version);
     std::string build_version_expression(VersionExpression expression) const;
 
 private:
+    friend class RngStreamGuard;
+
     AngbandSystem() = default;
 
     static AngbandSystem instance;
     bool phase_out_stat = false; // カジノ闘技場の観戦状態等に利用。NPCの処理の対象にならず自身もほとんどの行動ができない.
     Xoshiro128StarStar rng; //!< Uniform random bit generator for <random>
+    std::array<Xoshiro128StarStar, enum2i(RngStream::MAX)> rng_streams{}; //!< 用途毎の乱数列
+    Xoshiro128StarStar *current_rng = &this->rng; //!< get_rng() が返す乱数
+    bool is_rng_isolated = false; //!< シード固定の一時的な乱数を使用中か否か
     uint32_t seed_flavor{}; /* アイテム未鑑定名をシャッフルするための乱数シード */
     uint32_t seed_town{}; /* ランダム生成される町をレイアウトするための乱数シード */
     AngbandVersion version{};
@@ -29,7 +29,18 @@ constexpr std::string_view ROOT_VARIANT_NAME("Hengband");
 /*!
  * @brief セーブファイルのバージョン(3.0.0から導入)
  */
-constexpr uint32_t SAVEFILE_VERSION = 23;
+constexpr uint32_t SAVEFILE_VERSION = 24;
+
+/*!
+ * @brief 圧縮コンテナ形式のセーブファイルの識別子
+ * @details 先頭1バイトは、旧形式のバージョン番号及びバリアント名長と衝突しない値にすること.
+ */
+constexpr std::string_view SAVEFILE_CONTAINER_MAGIC("HBZ\x1a", 4);
+
+/*!
+ * @brief 圧縮コンテナ形式のバージョン
+ */
+constexpr uint8_t SAVEFILE_CONTAINER_VERSION = 1;
 
 /*!
  * @brief バージョンが開発版が安定版かを返す(廃止予定)
@@ -0,0 +1,39 @@
+#include "system/rng-stream-guard.h"
+
+/*!
+ * @brief 用途毎の乱数列に切り替える
+ * @param stream 乱数列の種別
+ */
+RngStreamGuard::RngStreamGuard(RngStream stream)
+{
+    auto &system = AngbandSystem::get_instance();
+    this->previous_rng = system.current_rng;
+    this->was_rng_isolated = system.is_rng_isolated;
+    if (!system.is_rng_isolated) {
+        system.current_rng = &system.get_rng_stream(stream);
+    }
+}
+
+/*!
+ * @brief シードを固定した一時的な乱数に切り替える
+ * @param isolated_rng 一時的な乱数
+ */
+RngStreamGuard::RngStreamGuard(const Xoshiro128StarStar &isolated_rng)
+    : isolated_rng(isolated_rng)
+{
+    auto &system = AngbandSystem::get_instance();
+    this->previous_rng = system.current_rng;
+    this->was_rng_isolated = system.is_rng_isolated;
+    system.current_rng = &this->isolated_rng;
+    system.is_rng_isolated = true;
+}
+
+/*!
+ * @brief 切り替える前の乱数に戻す
+ */
+RngStreamGuard::~RngStreamGuard()
+{
+    auto &system = AngbandSystem::get_instance();
+    system.current_rng = this->previous_rng;
+    system.is_rng_isolated = this->was_rng_isolated;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "system/angband-system.h"
+#include "util/rng-xoshiro.h"
+
+/*!
+ * @brief スコープの間だけ get_rng() が返す乱数を切り替えるクラス
+ * @details
+ * 用途毎の乱数列に切り替えると、その処理が消費した乱数はゲームの乱数や他の用途の乱数列に影響しない.
+ * シードを固定した一時的な乱数に切り替えた場合は、スコープ内で用途毎の乱数列へ切り替えようとしても無視し、
+ * スコープ内の処理結果がシードだけで決まるようにする.
+ */
+class RngStreamGuard {
+public:
+    explicit RngStreamGuard(RngStream stream);
+    explicit RngStreamGuard(const Xoshiro128StarStar &isolated_rng);
+    ~RngStreamGuard();
+    RngStreamGuard(const RngStreamGuard &) = delete;
+    RngStreamGuard(RngStreamGuard &&) = delete;
+    RngStreamGuard &operator=(const RngStreamGuard &) = delete;
+    RngStreamGuard &operator=(RngStreamGuard &&) = delete;
+
+private:
+    Xoshiro128StarStar isolated_rng; //!< シードを固定した一時的な乱数
+    Xoshiro128StarStar *previous_rng; //!< 切り替える前の乱数
+    bool was_rng_isolated; //!< 切り替える前に一時的な乱数を使用中だったか否か
+};
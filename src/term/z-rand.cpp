@@ -64,16 +64,9 @@ void Rand_state_init(void)
         std::generate(state.begin(), state.end(), [&dist, &rd] { return dist(rd); });
     } while (std::all_of(state.begin(), state.end(), [](auto s) { return s == 0; }));
 
-    AngbandSystem::get_instance().get_rng().set_state(state);
-}
-
-int rand_range(int a, int b)
-{
-    if (a >= b) {
-        return a;
-    }
-    std::uniform_int_distribution<> d(a, b);
-    return rand_dist(d);
+    auto &system = AngbandSystem::get_instance();
+    system.get_rng().set_state(state);
+    system.derive_rng_streams();
 }
 
 /*
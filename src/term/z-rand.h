@@ -30,7 +30,15 @@ constexpr auto RAND_DEG = 63;
  * The integer X falls along a uniform distribution.
  * Note: rand_range(0,N-1) == randint0(N)
  */
-int rand_range(int a, int b);
+inline int rand_range(int a, int b)
+{
+    if (a >= b) {
+        return a;
+    }
+
+    const auto range = static_cast<uint32_t>(b) - static_cast<uint32_t>(a) + 1;
+    return static_cast<int>(static_cast<uint32_t>(a) + AngbandSystem::get_instance().get_rng().bounded(range));
+}
 
 /*!
  * @brief 0以上/以下の一様乱数を返す
@@ -15,6 +15,7 @@
 #include "term/term-color-types.h"
 #include "term/z-virt.h"
 #include "view/display-symbol.h"
+#include <cstring>
 
 /* Special flags in the attr data */
 #define AF_BIGTILE2 0xf0
@@ -115,10 +116,10 @@ TermCenteredOffsetSetter::~TermCenteredOffsetSetter()
  * Initialize a "term_win" (using the given window size)
  */
 term_win::term_win(TERM_LEN w, TERM_LEN h)
-    : a(h, std::vector<TERM_COLOR>(w))
-    , c(h, std::vector<char>(w))
-    , ta(h, std::vector<TERM_COLOR>(w))
-    , tc(h, std::vector<char>(w))
+    : a(w, h)
+    , c(w, h)
+    , ta(w, h)
+    , tc(w, h)
 {
 }
 
@@ -142,21 +143,14 @@ std::unique_ptr<term_win> term_win::clone() const
 void term_win::resize(TERM_LEN w, TERM_LEN h)
 {
     /* Ignore non-changes */
-    if (this->a.size() == static_cast<size_t>(h) && this->a[0].size() == static_cast<size_t>(w)) {
+    if ((this->a.get_width() == w) && (this->a.get_height() == h)) {
         return;
     }
 
-    this->a.resize(h, std::vector<TERM_COLOR>(w));
-    this->c.resize(h, std::vector<char>(w));
-    this->ta.resize(h, std::vector<TERM_COLOR>(w));
-    this->tc.resize(h, std::vector<char>(w));
-
-    for (TERM_LEN y = 0; y < h; y++) {
-        this->a[y].resize(w);
-        this->c[y].resize(w);
-        this->ta[y].resize(w);
-        this->tc[y].resize(w);
-    }
+    this->a.resize(w, h);
+    this->c.resize(w, h);
+    this->ta.resize(w, h);
+    this->tc.resize(w, h);
 
     /* Illegal cursor */
     if (this->cx >= w) {
@@ -494,17 +488,17 @@ static void term_queue_chars(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, std::s
 {
     TERM_LEN x1 = -1, x2 = -1;
 
-    auto &scr_aa = game_term->scr->a[y];
+    auto *scr_aa = game_term->scr->a[y];
 #ifdef JP
-    auto &scr_cc = game_term->scr->c[y];
+    auto *scr_cc = game_term->scr->c[y];
 
-    auto &scr_taa = game_term->scr->ta[y];
-    auto &scr_tcc = game_term->scr->tc[y];
+    auto *scr_taa = game_term->scr->ta[y];
+    auto *scr_tcc = game_term->scr->tc[y];
 #else
-    auto &scr_cc = game_term->scr->c[y];
+    auto *scr_cc = game_term->scr->c[y];
 
-    auto &scr_taa = game_term->scr->ta[y];
-    auto &scr_tcc = game_term->scr->tc[y];
+    auto *scr_taa = game_term->scr->ta[y];
+    auto *scr_tcc = game_term->scr->tc[y];
 #endif
 
 #ifdef JP
@@ -622,23 +616,153 @@ static void term_queue_chars(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, std::s
 
 /*** Refresh routines ***/
 
+/*!
+ * @brief 画面の連続した8桁分の属性または文字を64ビット整数として読み出す
+ */
+template <typename T>
+static uint64_t term_load_block(const T *cells)
+{
+    static_assert(sizeof(T) == 1);
+    uint64_t block;
+    std::memcpy(&block, cells, sizeof(block));
+    return block;
+}
+
+/*!
+ * @brief 表示済みの画面と要求された画面で、指定行の連続した8桁のどこかが異なるかを返す
+ * @param y 行
+ * @param x 8桁の左端
+ * @param with_background 背景の属性と文字も比較するならtrue
+ */
+static bool term_is_block_changed(TERM_LEN y, TERM_LEN x, bool with_background)
+{
+    const auto &old = game_term->old;
+    const auto &scr = game_term->scr;
+    auto diff = term_load_block(&old->a[y][x]) ^ term_load_block(&scr->a[y][x]);
+    diff |= term_load_block(&old->c[y][x]) ^ term_load_block(&scr->c[y][x]);
+    if (with_background) {
+        diff |= term_load_block(&old->ta[y][x]) ^ term_load_block(&scr->ta[y][x]);
+        diff |= term_load_block(&old->tc[y][x]) ^ term_load_block(&scr->tc[y][x]);
+    }
+
+    return diff != 0;
+}
+
+/*!
+ * @brief 表示済みの画面と要求された画面で、指定した桁が異なるかを返す
+ */
+static bool term_is_cell_changed(TERM_LEN y, TERM_LEN x, bool with_background)
+{
+    const auto &old = game_term->old;
+    const auto &scr = game_term->scr;
+    auto changed = (old->a[y][x] != scr->a[y][x]) || (old->c[y][x] != scr->c[y][x]);
+    if (with_background) {
+        changed |= (old->ta[y][x] != scr->ta[y][x]) || (old->tc[y][x] != scr->tc[y][x]);
+    }
+
+    return changed;
+}
+
+/*!
+ * @brief 表示済みの画面と要求された画面で、指定行の内容が異なる最初の桁を求める
+ * @param y 行
+ * @param x1 調べる範囲の左端
+ * @param x2 調べる範囲の右端
+ * @param with_background 背景の属性と文字も比較するならtrue
+ * @return 最初の異なる桁. 範囲内が全て同じならx2 + 1
+ * @details 8桁ずつまとめて比較し、変化の無い区間を読み飛ばす.
+ */
+static TERM_LEN term_find_first_change(TERM_LEN y, TERM_LEN x1, TERM_LEN x2, bool with_background)
+{
+    constexpr TERM_LEN block_size = sizeof(uint64_t);
+    auto x = x1;
+    while ((x + block_size - 1 <= x2) && !term_is_block_changed(y, x, with_background)) {
+        x += block_size;
+    }
+
+    while ((x <= x2) && !term_is_cell_changed(y, x, with_background)) {
+        x++;
+    }
+
+    return x;
+}
+
+/*!
+ * @brief 表示済みの画面と要求された画面で、指定行の内容が異なる最後の桁を求める
+ * @param y 行
+ * @param x1 調べる範囲の左端 (内容が異なる桁であること)
+ * @param x2 調べる範囲の右端
+ * @param with_background 背景の属性と文字も比較するならtrue
+ * @return 最後の異なる桁
+ */
+static TERM_LEN term_find_last_change(TERM_LEN y, TERM_LEN x1, TERM_LEN x2, bool with_background)
+{
+    constexpr TERM_LEN block_size = sizeof(uint64_t);
+    auto x = x2;
+    while ((x - block_size + 1 > x1) && !term_is_block_changed(y, x - block_size + 1, with_background)) {
+        x -= block_size;
+    }
+
+    while (!term_is_cell_changed(y, x, with_background)) {
+        x--;
+    }
+
+    return x;
+}
+
+/*!
+ * @brief 行の先頭側の変化の無い桁を読み飛ばし、再描画を始める桁を求める
+ * @param y 行
+ * @param x1 再描画範囲の左端
+ * @param first_changed 最初に内容が異なる桁
+ * @return 再描画を始める桁
+ * @details 全角文字の2バイト目から描画を始めないよう、x1から全角文字を1組ずつ読み飛ばす.
+ * 2バイト目だけが変わった全角文字は1バイト目から描画する.
+ */
+static TERM_LEN term_skip_unchanged_columns(TERM_LEN y, TERM_LEN x1, TERM_LEN first_changed)
+{
+#ifdef JP
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
+    auto x = x1;
+    while (x < first_changed) {
+        if (!iskanji(scr_cc[x]) || (scr_aa[x] & AF_TILE1)) {
+            x++;
+            continue;
+        }
+
+        if (x + 1 >= first_changed) {
+            break;
+        }
+
+        x += 2;
+    }
+
+    return x;
+#else
+    (void)y;
+    (void)x1;
+    return first_changed;
+#endif
+}
+
 /*
  * Flush a row of the current window (see "term_fresh")
  * Display text using "term_pict()"
  */
 static void term_fresh_row_pict(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
 {
-    auto &old_aa = game_term->old->a[y];
-    auto &old_cc = game_term->old->c[y];
+    auto *old_aa = game_term->old->a[y];
+    auto *old_cc = game_term->old->c[y];
 
-    const auto &scr_aa = game_term->scr->a[y];
-    const auto &scr_cc = game_term->scr->c[y];
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
 
-    auto &old_taa = game_term->old->ta[y];
-    auto &old_tcc = game_term->old->tc[y];
+    auto *old_taa = game_term->old->ta[y];
+    auto *old_tcc = game_term->old->tc[y];
 
-    const auto &scr_taa = game_term->scr->ta[y];
-    const auto &scr_tcc = game_term->scr->tc[y];
+    const auto *scr_taa = game_term->scr->ta[y];
+    const auto *scr_tcc = game_term->scr->tc[y];
 
     TERM_COLOR ota;
     char otc;
@@ -717,6 +841,9 @@ static void term_fresh_row_pict(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
                 kanji = 0;
             }
 #endif
+            /* 変化の無い桁をまとめて読み飛ばす */
+            x = term_skip_unchanged_columns(y, x + 1, term_find_first_change(y, x + 1, x2, true)) - 1;
+
             /* Skip */
             continue;
         }
@@ -748,16 +875,16 @@ static void term_fresh_row_pict(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
  */
 static void term_fresh_row_both(TERM_LEN y, int x1, int x2)
 {
-    auto &old_aa = game_term->old->a[y];
-    auto &old_cc = game_term->old->c[y];
+    auto *old_aa = game_term->old->a[y];
+    auto *old_cc = game_term->old->c[y];
 
-    const auto &scr_aa = game_term->scr->a[y];
-    const auto &scr_cc = game_term->scr->c[y];
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
 
-    auto &old_taa = game_term->old->ta[y];
-    auto &old_tcc = game_term->old->tc[y];
-    const auto &scr_taa = game_term->scr->ta[y];
-    const auto &scr_tcc = game_term->scr->tc[y];
+    auto *old_taa = game_term->old->ta[y];
+    auto *old_tcc = game_term->old->tc[y];
+    const auto *scr_taa = game_term->scr->ta[y];
+    const auto *scr_tcc = game_term->scr->tc[y];
 
     TERM_COLOR ota;
     char otc;
@@ -849,6 +976,9 @@ static void term_fresh_row_both(TERM_LEN y, int x1, int x2)
                 kanji = 0;
             }
 #endif
+            /* 変化の無い桁をまとめて読み飛ばす */
+            x = term_skip_unchanged_columns(y, x + 1, term_find_first_change(y, x + 1, x2, true)) - 1;
+
             /* Skip */
             continue;
         }
@@ -949,11 +1079,11 @@ static void term_fresh_row_both(TERM_LEN y, int x1, int x2)
  */
 static void term_fresh_row_text(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
 {
-    auto &old_aa = game_term->old->a[y];
-    auto &old_cc = game_term->old->c[y];
+    auto *old_aa = game_term->old->a[y];
+    auto *old_cc = game_term->old->c[y];
 
-    const auto &scr_aa = game_term->scr->a[y];
-    const auto &scr_cc = game_term->scr->c[y];
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
 
     /* The "always_text" flag */
     int always_text = game_term->always_text;
@@ -1044,6 +1174,9 @@ static void term_fresh_row_text(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
                 kanji = 0;
             }
 #endif
+            /* 変化の無い桁をまとめて読み飛ばす */
+            x = term_skip_unchanged_columns(y, x + 1, term_find_first_change(y, x + 1, x2, false)) - 1;
+
             /* Skip */
             continue;
         }
@@ -1152,11 +1285,11 @@ errr term_fresh(void)
 
         /* Wipe each row */
         for (TERM_LEN y = 0; y < h; y++) {
-            auto &aa = old->a[y];
-            auto &cc = old->c[y];
+            auto *aa = old->a[y];
+            auto *cc = old->c[y];
 
-            auto &taa = old->ta[y];
-            auto &tcc = old->tc[y];
+            auto *taa = old->ta[y];
+            auto *tcc = old->tc[y];
 
             /* Wipe each column */
             for (TERM_LEN x = 0; x < w; x++) {
@@ -1191,11 +1324,11 @@ errr term_fresh(void)
             TERM_LEN tx = old->cx;
             TERM_LEN ty = old->cy;
 
-            const auto &old_aa = old->a[ty];
-            const auto &old_cc = old->c[ty];
+            const auto *old_aa = old->a[ty];
+            const auto *old_cc = old->c[ty];
 
-            const auto &old_taa = old->ta[ty];
-            const auto &old_tcc = old->tc[ty];
+            const auto *old_taa = old->ta[ty];
+            const auto *old_tcc = old->tc[ty];
 
             TERM_COLOR ota = old_taa[tx];
             char otc = old_tcc[tx];
@@ -1253,11 +1386,33 @@ errr term_fresh(void)
             }
         }
 
+        /* 文字だけで描画する場合は背景の属性と文字を表示済みの画面へ反映しないので比較しない */
+        const auto with_background = game_term->always_pict || game_term->higher_pict;
+
         /* Scan the "modified" rows */
         for (TERM_LEN y = y1; y <= y2; ++y) {
             TERM_LEN x1 = game_term->x1[y];
             TERM_LEN x2 = game_term->x2[y];
 
+            /*
+             * 再描画範囲のうち実際に内容が変わった範囲だけを描画する.
+             * 右端の全角文字の2バイト目も比較するため、範囲の1桁右まで調べる.
+             */
+            if (x1 <= x2) {
+                const auto x2_checked = std::min(x2 + 1, w - 1);
+                const auto first_changed = term_find_first_change(y, x1, x2_checked, with_background);
+                if (first_changed <= x2_checked) {
+                    x2 = std::min(x2, term_find_last_change(y, first_changed, x2_checked, with_background) + 1);
+                    x1 = term_skip_unchanged_columns(y, x1, first_changed);
+                } else {
+                    x1 = w;
+                }
+
+                /* This row is all done */
+                game_term->x1[y] = w;
+                game_term->x2[y] = 0;
+            }
+
             /* Flush each "modified" row */
             if (x1 <= x2) {
                 /* Always use "term_pict()" */
@@ -1278,10 +1433,6 @@ errr term_fresh(void)
                     term_fresh_row_text(y, x1, x2);
                 }
 
-                /* This row is all done */
-                game_term->x1[y] = w;
-                game_term->x2[y] = 0;
-
                 /* Flush that row (if allowed) */
                 if (!game_term->never_frosh) {
                     term_xtra(TERM_XTRA_FROSH, y);
@@ -1332,6 +1483,8 @@ errr term_fresh(void)
 
     /* Actually flush the output */
     term_xtra(TERM_XTRA_FRESH, 0);
+    game_term->last_fresh_time = std::chrono::steady_clock::now();
+    game_term->fresh_deferred = false;
 
     if (!game_term->soft_cursor && !scr->cu && scr->cv) {
         /* The cursor is visible, display it correctly */
@@ -1353,6 +1506,24 @@ errr term_fresh_force(void)
     return err;
 }
 
+/*
+ * @brief フレーム間隔の制限に従って term_fresh_force() を行う
+ * @details 前回画面を実際に更新してから arg_frame_rate で決まる間隔が経っていなければ更新を見送る.
+ * 見送った描画は次に更新する時か、キー入力を待つ前にまとめて反映される.
+ */
+errr term_fresh_scheduled(void)
+{
+    if (arg_frame_rate > 0) {
+        const auto frame_interval = std::chrono::steady_clock::duration(std::chrono::seconds(1)) / arg_frame_rate;
+        if (std::chrono::steady_clock::now() - game_term->last_fresh_time < frame_interval) {
+            game_term->fresh_deferred = true;
+            return 1;
+        }
+    }
+
+    return term_fresh_force();
+}
+
 /*** Output routines ***/
 
 /*
@@ -1624,11 +1795,11 @@ errr term_erase(TERM_LEN x, TERM_LEN y, std::optional<int> n_opt)
     }
 
     /* Fast access */
-    auto &scr_aa = game_term->scr->a[y];
-    auto &scr_cc = game_term->scr->c[y];
+    auto *scr_aa = game_term->scr->a[y];
+    auto *scr_cc = game_term->scr->c[y];
 
-    auto &scr_taa = game_term->scr->ta[y];
-    auto &scr_tcc = game_term->scr->tc[y];
+    auto *scr_taa = game_term->scr->ta[y];
+    auto *scr_tcc = game_term->scr->tc[y];
 
 #ifdef JP
     /*
@@ -1725,11 +1896,11 @@ errr term_clear(void)
 
     /* Wipe each row */
     for (TERM_LEN y = 0; y < h; y++) {
-        auto &scr_aa = game_term->scr->a[y];
-        auto &scr_cc = game_term->scr->c[y];
+        auto *scr_aa = game_term->scr->a[y];
+        auto *scr_cc = game_term->scr->c[y];
 
-        auto &scr_taa = game_term->scr->ta[y];
-        auto &scr_tcc = game_term->scr->tc[y];
+        auto *scr_taa = game_term->scr->ta[y];
+        auto *scr_tcc = game_term->scr->tc[y];
 
         /* Wipe each column */
         for (TERM_LEN x = 0; x < w; x++) {
@@ -1809,7 +1980,7 @@ errr term_redraw_section(TERM_LEN x1, TERM_LEN y1, TERM_LEN x2, TERM_LEN y2)
         game_term->x1[i] = x1j;
         game_term->x2[i] = x2j;
 
-        auto &g_ptr = game_term->old->c[i];
+        auto *g_ptr = game_term->old->c[i];
 
         /* Clear the section so it is redrawn */
         for (int j = x1j; j <= x2j; j++) {
@@ -1820,7 +1991,7 @@ errr term_redraw_section(TERM_LEN x1, TERM_LEN y1, TERM_LEN x2, TERM_LEN y2)
         game_term->x1[i] = x1;
         game_term->x2[i] = x2;
 
-        auto &g_ptr = game_term->old->c[i];
+        auto *g_ptr = game_term->old->c[i];
 
         /* Clear the section so it is redrawn */
         for (int j = x1; j <= x2; j++) {
@@ -1960,6 +2131,11 @@ errr term_inkey(char *ch, bool wait, bool take)
 
     /* Wait */
     if (wait) {
+        /* フレーム間隔の制限で見送った描画を、入力を待つ前に反映する */
+        if (game_term->fresh_deferred) {
+            term_fresh_force();
+        }
+
         /* Process pending events while necessary */
         while (game_term->key_head == game_term->key_tail) {
             /* Process events (wait for one) */
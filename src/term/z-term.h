@@ -10,6 +10,8 @@
 
 #include "system/angband.h"
 #include "system/h-basic.h"
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <stack>
@@ -17,6 +19,68 @@
 #include <utility>
 #include <vector>
 
+/*!
+ * @brief 画面の属性または文字を保持する2次元配列
+ * @details 全ての行を行優先で1つの連続した領域に持つ. grid[y] で行の先頭を指すポインタが得られるため、
+ * 要素には従来の2次元配列と同じく grid[y][x] でアクセスでき、1行分を描画フックへそのまま渡せる.
+ */
+template <typename T>
+class TermGrid {
+public:
+    TermGrid(TERM_LEN w, TERM_LEN h)
+        : w(w)
+        , h(h)
+        , cells(static_cast<size_t>(w) * h)
+    {
+    }
+
+    T *operator[](TERM_LEN y)
+    {
+        return &this->cells[static_cast<size_t>(y) * this->w];
+    }
+
+    const T *operator[](TERM_LEN y) const
+    {
+        return &this->cells[static_cast<size_t>(y) * this->w];
+    }
+
+    TERM_LEN get_width() const
+    {
+        return this->w;
+    }
+
+    TERM_LEN get_height() const
+    {
+        return this->h;
+    }
+
+    /*!
+     * @brief 大きさを変える. 新旧の大きさが重なる部分の内容は保持し、広がった部分は0で埋める
+     */
+    void resize(TERM_LEN new_w, TERM_LEN new_h)
+    {
+        if ((new_w == this->w) && (new_h == this->h)) {
+            return;
+        }
+
+        std::vector<T> new_cells(static_cast<size_t>(new_w) * new_h);
+        const auto copy_w = std::min(this->w, new_w);
+        const auto copy_h = std::min(this->h, new_h);
+        for (TERM_LEN y = 0; y < copy_h; y++) {
+            std::copy_n((*this)[y], copy_w, &new_cells[static_cast<size_t>(y) * new_w]);
+        }
+
+        this->cells = std::move(new_cells);
+        this->w = new_w;
+        this->h = new_h;
+    }
+
+private:
+    TERM_LEN w;
+    TERM_LEN h;
+    std::vector<T> cells;
+};
+
 /*!
  * @brief A term_win is a "window" for a Term
  */
@@ -29,11 +93,11 @@ public:
     bool cu{}, cv{}; //!< Cursor Useless / Visible codes
     TERM_LEN cx{}, cy{}; //!< Cursor Location (see "Useless")
 
-    std::vector<std::vector<TERM_COLOR>> a; //!< Array[h*w] -- Attribute array
-    std::vector<std::vector<char>> c; //!< Array[h*w] -- Character array
+    TermGrid<TERM_COLOR> a; //!< Array[h*w] -- Attribute array
+    TermGrid<char> c; //!< Array[h*w] -- Character array
 
-    std::vector<std::vector<TERM_COLOR>> ta; //!< Note that the attr pair at(x, y) is a[y][x]
-    std::vector<std::vector<char>> tc; //!< Note that the char pair at(x, y) is c[y][x]
+    TermGrid<TERM_COLOR> ta; //!< Note that the attr pair at(x, y) is a[y][x]
+    TermGrid<char> tc; //!< Note that the char pair at(x, y) is c[y][x]
 
 private:
     term_win(TERM_LEN w, TERM_LEN h);
@@ -87,6 +151,9 @@ struct term_type {
     std::vector<TERM_LEN> x1; //!< Minimum modified column(per row)
     std::vector<TERM_LEN> x2; //!< Maximum modified column(per row)
 
+    std::chrono::steady_clock::time_point last_fresh_time{}; //!< 最後に画面を実際に更新した時刻
+    bool fresh_deferred{}; //!< フレーム間隔の制限で更新を見送った描画が残っているか
+
     std::unique_ptr<term_win> old; //!< Displayed screen image
     std::unique_ptr<term_win> scr; //!< Requested screen image
 
@@ -202,6 +269,7 @@ void term_queue_line(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR *a, char *c, TERM
 
 errr term_fresh();
 errr term_fresh_force();
+errr term_fresh_scheduled();
 errr term_set_cursor(int v);
 errr term_gotoxy(TERM_LEN x, TERM_LEN y);
 errr term_draw(TERM_LEN x, TERM_LEN y, TERM_COLOR a, char c);
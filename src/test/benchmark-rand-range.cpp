@@ -0,0 +1,57 @@
+/*!
+ * @brief 範囲指定の一様乱数生成の速度を比較するベンチマークプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -O2 -I. test/benchmark-rand-range.cpp util/rng-xoshiro.cpp
+ *
+ * std::uniform_int_distribution を毎回構築する従来の方法と Xoshiro128StarStar::bounded() について、
+ * ゲーム中でよく使われる範囲の乱数を生成する時間を計測する
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "util/rng-xoshiro.h"
+
+constexpr auto SAMPLE_COUNT = 50000000;
+
+/*!
+ * @brief 処理時間を計測して表示する
+ * @param name 表示する名前
+ * @param func 1回分の乱数を生成する処理
+ */
+template <typename F>
+static void measure(const char *name, F func)
+{
+    uint64_t sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < SAMPLE_COUNT; i++) {
+        sum += func(i);
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed / SAMPLE_COUNT << " ns/call (checksum " << sum << ")" << std::endl;
+}
+
+int main()
+{
+    // randint0(100), randint1(6) など小さな範囲を中心に、範囲を呼び出し毎に変える
+    constexpr uint32_t ranges[] = { 100, 6, 2, 1000, 20, 3, 10000, 50 };
+    constexpr auto range_count = std::size(ranges);
+
+    Xoshiro128StarStar rng_dist(42);
+    measure("std::uniform_int_distribution", [&rng_dist, &ranges](int i) {
+        std::uniform_int_distribution<> d(0, static_cast<int>(ranges[i % range_count]) - 1);
+        return static_cast<uint32_t>(d(rng_dist));
+    });
+
+    Xoshiro128StarStar rng_bounded(42);
+    measure("Xoshiro128StarStar::bounded", [&rng_bounded, &ranges](int i) {
+        return rng_bounded.bounded(ranges[i % range_count]);
+    });
+
+    return 0;
+}
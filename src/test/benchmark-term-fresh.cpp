@@ -0,0 +1,186 @@
+/*!
+ * @brief term_fresh() の速度を計測するベンチマークプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -O2 -I. test/benchmark-term-fresh.cpp term/z-term.cpp game-option/special-options.cpp game-option/runtime-arguments.cpp
+ *
+ * 200x60の画面全体にマップを描画した状態から、以下の3通りの再描画に掛かる時間を計測する.
+ * - 中央にポップアップを開き、閉じる (閉じた時は画面全体が再描画対象になるが、変わるのは中央の一部だけ)
+ * - 毎フレーム各行の両端だけが変わる (行の中ほどは変わっていないが再描画対象になる)
+ * - 毎フレーム全ての桁が変わる
+ * 描画フックに渡された内容のチェックサムも表示するので、実装を変えた前後で描画結果が同じことを確かめられる
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "term/z-term.h"
+
+constexpr TERM_LEN TERM_WIDTH = 200;
+constexpr TERM_LEN TERM_HEIGHT = 60;
+constexpr auto FRAME_COUNT = 2000;
+
+namespace {
+uint64_t hook_checksum = 0; //!< 描画フックに渡された内容のチェックサム
+int hook_calls = 0; //!< 描画フックの呼び出し回数
+
+void mix_checksum(uint64_t value)
+{
+    hook_checksum = (hook_checksum ^ value) * 0x100000001b3ULL;
+}
+
+errr bench_text(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, concptr s)
+{
+    hook_calls++;
+    mix_checksum((static_cast<uint64_t>(y) << 32) | (x << 16) | (n << 8) | a);
+    for (auto i = 0; i < n; i++) {
+        mix_checksum(static_cast<uint8_t>(s[i]));
+    }
+
+    return 0;
+}
+
+errr bench_wipe(TERM_LEN x, TERM_LEN y, int n)
+{
+    hook_calls++;
+    mix_checksum((static_cast<uint64_t>(y) << 32) | (x << 16) | n);
+    return 0;
+}
+
+errr bench_pict(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *ap, concptr cp, const TERM_COLOR *tap, concptr tcp)
+{
+    hook_calls++;
+    mix_checksum((static_cast<uint64_t>(y) << 32) | (x << 16) | n);
+    for (auto i = 0; i < n; i++) {
+        mix_checksum((ap[i] << 24) | (static_cast<uint8_t>(cp[i]) << 16) | (tap[i] << 8) | static_cast<uint8_t>(tcp[i]));
+    }
+
+    return 0;
+}
+
+errr bench_curs(TERM_LEN, TERM_LEN)
+{
+    return 0;
+}
+
+errr bench_xtra(int, int)
+{
+    return 0;
+}
+
+/*!
+ * @brief 1行分のマップを作る
+ * @param y 行
+ * @param frame フレーム番号 (変わる桁の内容に使う)
+ * @param changed_columns 変わる桁を決める関数
+ */
+template <typename F>
+void queue_map_row(TERM_LEN y, int frame, F changed_columns)
+{
+    std::vector<TERM_COLOR> a(TERM_WIDTH);
+    std::vector<char> c(TERM_WIDTH);
+    std::vector<TERM_COLOR> ta(TERM_WIDTH);
+    std::vector<char> tc(TERM_WIDTH);
+    for (TERM_LEN x = 0; x < TERM_WIDTH; x++) {
+        const auto changed = changed_columns(x);
+        a[x] = static_cast<TERM_COLOR>(1 + (x * 7 + y * 3 + (changed ? frame : 0)) % 15);
+        c[x] = static_cast<char>("#.:'+^<>"[(x + y + (changed ? frame : 0)) % 8]);
+    }
+
+    term_queue_line(0, y, TERM_WIDTH, a.data(), c.data(), ta.data(), tc.data());
+}
+
+/*!
+ * @brief 全フレームの描画に掛かった時間を計測して表示する
+ * @param name 表示する名前
+ * @param draw_frame 1フレーム分の描画対象を積む処理
+ */
+template <typename F>
+void measure(const char *name, F draw_frame)
+{
+    term_clear();
+    for (TERM_LEN y = 0; y < TERM_HEIGHT; y++) {
+        queue_map_row(y, 0, [](TERM_LEN) { return false; });
+    }
+
+    term_fresh();
+    hook_checksum = 0;
+    hook_calls = 0;
+
+    auto elapsed = 0.0;
+    for (auto frame = 1; frame <= FRAME_COUNT; frame++) {
+        draw_frame(frame);
+        const auto start = std::chrono::steady_clock::now();
+        term_fresh();
+        elapsed += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::cout << name << ": " << elapsed / FRAME_COUNT << " us/frame (hook calls " << hook_calls << ", checksum " << hook_checksum << ")" << std::endl;
+}
+
+void run_benchmark(const char *mode_name)
+{
+    std::cout << "[" << mode_name << "]" << std::endl;
+    measure("open and close popup", [](int frame) {
+        if (frame % 2) {
+            term_save();
+            std::string popup(40, static_cast<char>('a' + frame % 26));
+#ifdef JP
+            // 全角文字の位置をフレーム毎にずらし、全角文字の途中から変わる場合も確かめる
+            for (auto x = frame % 4; x + 1 < std::ssize(popup); x += 4) {
+                popup[x] = '\xa4';
+                popup[x + 1] = static_cast<char>(0xa2 + frame % 8);
+            }
+#endif
+            for (TERM_LEN y = 20; y < 40; y++) {
+                term_putstr(80, y, -1, static_cast<TERM_COLOR>(1 + frame % 15), popup);
+            }
+
+            return;
+        }
+
+        // 画面全体が再描画対象になるが、実際に変わるのはポップアップの部分だけ
+        term_load(false);
+    });
+
+    measure("both ends changed", [](int frame) {
+        for (TERM_LEN y = 0; y < TERM_HEIGHT; y++) {
+            queue_map_row(y, frame, [](TERM_LEN x) { return (x < 2) || (x >= TERM_WIDTH - 2); });
+        }
+    });
+
+    measure("all changed", [](int frame) {
+        for (TERM_LEN y = 0; y < TERM_HEIGHT; y++) {
+            queue_map_row(y, frame, [](TERM_LEN) { return true; });
+        }
+    });
+}
+}
+
+int main()
+{
+    term_type term;
+    term_init(&term, TERM_WIDTH, TERM_HEIGHT, 256);
+    term.text_hook = bench_text;
+    term.wipe_hook = bench_wipe;
+    term.pict_hook = bench_pict;
+    term.curs_hook = bench_curs;
+    term.xtra_hook = bench_xtra;
+    term.mapped_flag = true;
+    term.never_frosh = true;
+    term_activate(&term);
+
+    run_benchmark("text");
+
+    term.higher_pict = true;
+    run_benchmark("text and pict");
+
+    term.higher_pict = false;
+    term.always_pict = true;
+    run_benchmark("pict");
+    return 0;
+}
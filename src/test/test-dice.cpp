@@ -0,0 +1,195 @@
+/*!
+ * @brief ダイスの分布表のテストプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -I. test/test-dice.cpp util/dice.cpp util/rng-xoshiro.cpp util/string-processor.cpp term/z-rand.cpp system/angband-system.cpp main-unix/stack-trace-unix.cpp system/angband-version.cpp term/z-form.cpp term/z-util.cpp
+ *
+ * 分布表の組み合わせ数と順位から合計への対応が、全ての組み合わせを数え上げた結果と完全に一致することを確かめる.
+ * また、分布表を使う場合と使わない場合のそれぞれで Dice::roll() の出目が正しい分布に従うことを確かめる.
+ * 失敗した場合はassertでプログラムが停止する
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "system/angband-system.h"
+#include "util/dice.h"
+
+/*!
+ * @brief 全ての組み合わせを数え上げて出目の合計毎の組み合わせ数を求める
+ */
+static std::map<int, uint64_t> enumerate_sums(int num, int sides)
+{
+    std::map<int, uint64_t> counts;
+    std::vector<int> faces(num, 1);
+    while (true) {
+        auto sum = 0;
+        for (const auto face : faces) {
+            sum += face;
+        }
+
+        counts[sum]++;
+        auto i = 0;
+        while ((i < num) && (faces[i] == sides)) {
+            faces[i] = 1;
+            i++;
+        }
+
+        if (i == num) {
+            return counts;
+        }
+
+        faces[i]++;
+    }
+}
+
+/*!
+ * @brief ダイスを1個ずつ加える素朴な動的計画法で出目の合計毎の組み合わせ数を求める
+ */
+static std::vector<uint64_t> count_sums_naive(int num, int sides)
+{
+    std::vector<uint64_t> counts(num * sides + 1);
+    counts[0] = 1;
+    for (auto i = 0; i < num; i++) {
+        std::vector<uint64_t> next_counts(counts.size());
+        for (auto sum = 0; sum < static_cast<int>(counts.size()); sum++) {
+            for (auto face = 1; (face <= sides) && (sum + face < static_cast<int>(counts.size())); face++) {
+                next_counts[sum + face] += counts[sum];
+            }
+        }
+
+        counts = next_counts;
+    }
+
+    return counts;
+}
+
+/*!
+ * @brief 小さなダイスについて、分布表が数え上げの結果と完全に一致することを確かめる
+ */
+static void test_exhaustive(int num, int sides)
+{
+    const DiceDistribution distribution(num, sides);
+    const auto expected = enumerate_sums(num, sides);
+    uint64_t total = 0;
+    for (auto sum = num - 1; sum <= num * sides + 1; sum++) {
+        const auto it = expected.find(sum);
+        assert(distribution.count(sum) == ((it == expected.end()) ? 0 : it->second));
+        total += distribution.count(sum);
+    }
+
+    assert(distribution.get_total() == total);
+
+    // 全ての順位を合計に写した結果も同じ分布になる
+    std::map<int, uint64_t> found;
+    for (uint64_t rank = 0; rank < distribution.get_total(); rank++) {
+        found[distribution.find_sum(rank)]++;
+    }
+
+    assert(found == expected);
+}
+
+/*!
+ * @brief 数え上げられない大きさのダイスについて、分布表を素朴な計算と比較する
+ */
+static void test_large(int num, int sides)
+{
+    const DiceDistribution distribution(num, sides);
+    const auto expected = count_sums_naive(num, sides);
+    for (auto sum = 0; sum < static_cast<int>(expected.size()); sum++) {
+        assert(distribution.count(sum) == expected[sum]);
+    }
+
+    assert(distribution.find_sum(0) == num);
+    assert(distribution.find_sum(distribution.get_total() - 1) == num * sides);
+}
+
+/*!
+ * @brief Dice::roll() の出目の分布をカイ二乗検定で確かめる
+ */
+static void test_roll(int num, int sides, int roll_count)
+{
+    const auto expected = count_sums_naive(num, sides);
+    const auto total = std::pow(static_cast<double>(sides), num);
+    std::map<int, int> rolled;
+    for (auto i = 0; i < roll_count; i++) {
+        const auto sum = Dice::roll(num, sides);
+        assert((sum >= num) && (sum <= num * sides));
+        rolled[sum]++;
+    }
+
+    // 期待度数が小さすぎる合計は両端にまとめる
+    auto chi_square = 0.0;
+    auto bins = 0;
+    auto pending_expected = 0.0;
+    auto pending_observed = 0;
+    for (auto sum = num; sum <= num * sides; sum++) {
+        pending_expected += expected[sum] / total * roll_count;
+        pending_observed += rolled[sum];
+        if ((pending_expected < 10.0) && (sum < num * sides)) {
+            continue;
+        }
+
+        chi_square += (pending_observed - pending_expected) * (pending_observed - pending_expected) / pending_expected;
+        bins++;
+        pending_expected = 0.0;
+        pending_observed = 0;
+    }
+
+    const auto df = static_cast<double>(bins - 1);
+    const auto threshold = df + 4.0 * std::sqrt(2.0 * df) + 10.0;
+    std::cout << num << "d" << sides << ": chi^2 = " << chi_square << " (threshold " << threshold << ")" << std::endl;
+    assert(chi_square < threshold);
+}
+
+/*!
+ * @brief 分布表を作れない大きさのダイスについて、Dice::roll() の出目の範囲と平均を確かめる
+ */
+static void test_roll_untabulated(int num, int sides, int roll_count)
+{
+    assert(!DiceDistribution::can_tabulate(num, sides));
+    auto total = 0.0;
+    for (auto i = 0; i < roll_count; i++) {
+        const auto sum = Dice::roll(num, sides);
+        assert((sum >= num) && (sum <= num * sides));
+        total += sum;
+    }
+
+    // 標準偏差 sqrt(num * (sides^2 - 1) / 12 / roll_count) の6倍以内
+    const auto mean = total / roll_count;
+    const auto sigma = std::sqrt(num * (static_cast<double>(sides) * sides - 1) / 12.0 / roll_count);
+    std::cout << num << "d" << sides << ": mean = " << mean << " (expected " << Dice::expected_value(num, sides) << ")" << std::endl;
+    assert(std::abs(mean - Dice::expected_value(num, sides)) < 6.0 * sigma);
+}
+
+int main()
+{
+    for (auto num = 1; num <= 6; num++) {
+        for (auto sides = 1; sides <= 8; sides++) {
+            test_exhaustive(num, sides);
+        }
+    }
+
+    test_exhaustive(3, 100);
+    test_large(10, 10);
+    test_large(20, 6);
+    test_large(63, 2);
+    test_large(9, 100);
+    assert(!DiceDistribution::can_tabulate(64, 2));
+    assert(!DiceDistribution::can_tabulate(50, 100));
+
+    AngbandSystem::get_instance().set_rng(Xoshiro128StarStar(1234));
+    test_roll(3, 6, 200000); // 分布表を使わない
+    test_roll(5, 6, 200000);
+    test_roll(10, 10, 200000);
+    test_roll(20, 6, 200000); // 組み合わせ総数が2^32を超える
+    test_roll_untabulated(50, 100, 20000);
+
+    std::cout << "All tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*!
+ * @brief Xoshiro128StarStar::bounded() と rand_range() のテストプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -I. test/test-rng-bounded.cpp util/rng-xoshiro.cpp term/z-rand.cpp system/angband-system.cpp main-unix/stack-trace-unix.cpp system/angband-version.cpp term/z-form.cpp term/z-util.cpp
+ *
+ * 固定シードでの出力が既知の値と一致すること (どの環境でも同じ乱数列になること) と、
+ * 各範囲で出力が一様に分布していることをカイ二乗検定で確かめる. 失敗した場合はassertでプログラムが停止する
+ */
+
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "system/angband-system.h"
+#include "term/z-rand.h"
+#include "util/rng-xoshiro.h"
+
+/*!
+ * @brief 固定シードでの出力を既知の値と比較する
+ * @details 既知の値は xoshiro128** と乗算シフト法を素直に実装した別のプログラムで計算したもの.
+ */
+static void test_known_answer()
+{
+    constexpr std::array<uint32_t, 12> expected_dice{ 3, 0, 0, 0, 5, 5, 5, 0, 2, 4, 5, 3 };
+    constexpr std::array<uint32_t, 6> expected_large{ 551374917, 885866824, 325593718, 864876470, 805915106, 417497993 };
+    constexpr std::array<uint32_t, 4> expected_full{ 1807686378, 9053939, 3662444335, 759406123 };
+
+    Xoshiro128StarStar rng(12345);
+    for (const auto expected : expected_dice) {
+        assert(rng.bounded(6) == expected);
+    }
+
+    for (const auto expected : expected_large) {
+        assert(rng.bounded(1000000007U) == expected);
+    }
+
+    for (const auto expected : expected_full) {
+        assert(rng.bounded(0) == expected);
+    }
+}
+
+/*!
+ * @brief 出力をbin_count個の区間に振り分け、カイ二乗検定で一様性を確かめる
+ * @param range bounded() に渡す範囲
+ * @param bin_count 区間の数 (rangeの約数であること)
+ * @param sample_count 生成する乱数の個数
+ */
+static void test_uniformity(uint32_t range, uint32_t bin_count, int sample_count)
+{
+    static Xoshiro128StarStar rng(314159);
+    const auto bin_width = (range == 0) ? (UINT64_C(1) << 32) / bin_count : range / bin_count;
+    std::vector<int> bins(bin_count);
+    for (auto i = 0; i < sample_count; i++) {
+        const auto value = rng.bounded(range);
+        assert((range == 0) || (value < range));
+        bins[value / bin_width]++;
+    }
+
+    const auto expected = static_cast<double>(sample_count) / bin_count;
+    auto chi_square = 0.0;
+    for (const auto count : bins) {
+        chi_square += (count - expected) * (count - expected) / expected;
+    }
+
+    // 自由度dfのカイ二乗分布の上側確率がおよそ0.01%となる値を近似的に閾値とする
+    const auto df = static_cast<double>(bin_count - 1);
+    const auto threshold = df + 4.0 * std::sqrt(2.0 * df) + 10.0;
+    std::cout << "range = " << range << ", bins = " << bin_count << ", chi^2 = " << chi_square << " (threshold " << threshold << ")" << std::endl;
+    assert(chi_square < threshold);
+}
+
+/*!
+ * @brief rand_range() が端点を含む範囲の値だけを返すことを確かめる
+ */
+static void test_rand_range()
+{
+    AngbandSystem::get_instance().set_rng(Xoshiro128StarStar(2718));
+    std::array<int, 7> counts{};
+    for (auto i = 0; i < 70000; i++) {
+        const auto value = rand_range(-3, 3);
+        assert((value >= -3) && (value <= 3));
+        counts[value + 3]++;
+    }
+
+    for (const auto count : counts) {
+        assert(count > 0);
+    }
+
+    assert(rand_range(5, 5) == 5);
+    assert(rand_range(7, 2) == 7);
+    for (auto i = 0; i < 1000; i++) {
+        const auto value = rand_range(INT_MAX - 1, INT_MAX);
+        assert((value == INT_MAX - 1) || (value == INT_MAX));
+        (void)rand_range(INT_MIN, INT_MAX);
+    }
+}
+
+int main()
+{
+    test_known_answer();
+    test_rand_range();
+
+    test_uniformity(2, 2, 1000000);
+    test_uniformity(6, 6, 1000000);
+    test_uniformity(100, 100, 1000000);
+    test_uniformity(1000, 1000, 2000000);
+
+    // 単純な剰余では下位1/3の値が2倍選ばれやすくなる範囲. 棄却が正しく働いていれば3区間が均等になる
+    test_uniformity(3U << 30, 3, 3000000);
+    test_uniformity(0, 16, 1000000);
+
+    std::cout << "All tests passed." << std::endl;
+    return 0;
+}
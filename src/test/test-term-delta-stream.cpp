@@ -0,0 +1,336 @@
+/*!
+ * @brief 画面の差分ストリームの符号化・復号のテストプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -I. test/test-term-delta-stream.cpp io/term-delta-stream.cpp main-unix/stack-trace-unix.cpp system/angband-version.cpp term/z-form.cpp term/z-util.cpp
+ *
+ * 文字列の描画・消去・画面全体の消去・大きさの変更を乱数で繰り返し、
+ * 差分フレームを順に復号した画面と、キーフレームだけを復号した画面のどちらも実際の画面と一致することを確かめる.
+ * また、録画ファイルの末尾の索引が符号化・復号でき、時刻とゲームターンからキーフレームを探せることと、画面の外を指す命令を弾くことを確かめる.
+ * 失敗した場合はassertでプログラムが停止する
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "io/term-delta-stream.h"
+
+namespace {
+struct Cell {
+    TERM_COLOR a = 0;
+    char c = ' ';
+
+    bool operator==(const Cell &other) const = default;
+};
+
+/*!
+ * @brief 画面を模したもの
+ */
+struct Screen {
+    TERM_LEN w = 0;
+    TERM_LEN h = 0;
+    std::vector<Cell> cells;
+
+    void resize(TERM_LEN new_w, TERM_LEN new_h)
+    {
+        this->w = new_w;
+        this->h = new_h;
+        this->cells.assign(static_cast<size_t>(new_w) * new_h, Cell());
+    }
+
+    Cell &at(TERM_LEN x, TERM_LEN y)
+    {
+        return this->cells[static_cast<size_t>(y) * this->w + x];
+    }
+
+    bool operator==(const Screen &other) const = default;
+};
+
+/*!
+ * @brief フレームを全て復号して画面に反映する
+ * @return 復号したフレームの数
+ */
+int apply_stream(TermDeltaDecoder &decoder, Screen &screen, std::string_view stream)
+{
+    auto frame_count = 0;
+    while (!stream.empty()) {
+        size_t frame_size = 0;
+        const auto frame = TermDeltaDecoder::read_frame(stream, frame_size);
+        assert(frame);
+        decoder.start_frame(frame->ops);
+        while (const auto op = decoder.next_op()) {
+            switch (op->type) {
+            case TermDeltaOpType::SIZE:
+                screen.resize(op->x, op->y);
+                break;
+            case TermDeltaOpType::CLEAR:
+                std::fill(screen.cells.begin(), screen.cells.end(), Cell());
+                break;
+            case TermDeltaOpType::TEXT:
+                for (auto i = 0; i < op->n; i++) {
+                    screen.at(op->x + i, op->y) = { op->attr, op->text[i] };
+                }
+
+                break;
+            case TermDeltaOpType::REPEAT:
+                for (auto i = 0; i < op->n; i++) {
+                    screen.at(op->x + i, op->y) = { op->attr, op->text.front() };
+                }
+
+                break;
+            case TermDeltaOpType::WIPE:
+                for (auto i = 0; i < op->n; i++) {
+                    screen.at(op->x + i, op->y) = Cell();
+                }
+
+                break;
+            default:
+                break;
+            }
+        }
+
+        stream.remove_prefix(frame_size);
+        frame_count++;
+    }
+
+    return frame_count;
+}
+
+/*!
+ * @brief フレームの途中で切れたバッファからはフレームを切り出さないことを確かめる
+ */
+void test_truncated_frame(std::string_view frame)
+{
+    for (size_t size = 0; size < frame.size(); size++) {
+        size_t frame_size = 0;
+        assert(!TermDeltaDecoder::read_frame(frame.substr(0, size), frame_size));
+    }
+}
+
+/*!
+ * @brief 命令の列を varint の列から作る
+ * @param type 命令の種別
+ * @param values 命令の引数
+ */
+std::string make_op(TermDeltaOpType type, std::initializer_list<uint64_t> values)
+{
+    std::string op(1, static_cast<char>(type));
+    for (auto value : values) {
+        while (value >= 0x80) {
+            op.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+
+        op.push_back(static_cast<char>(value));
+    }
+
+    return op;
+}
+
+/*!
+ * @brief 命令の列を最後まで復号し、例外が投げられたかを返す
+ */
+bool is_rejected(const std::string &ops)
+{
+    TermDeltaDecoder decoder;
+    decoder.start_frame(ops);
+    try {
+        while (decoder.next_op()) {
+        }
+    } catch (const std::exception &) {
+        return true;
+    }
+
+    return false;
+}
+
+/*!
+ * @brief 画面の外を指す命令や int に収まらない値の命令を、切り詰める前に弾くことを確かめる
+ */
+void test_malformed_ops()
+{
+    const auto size = make_op(TermDeltaOpType::SIZE, { 80, 24 });
+    assert(!is_rejected(size + make_op(TermDeltaOpType::WIPE, { 80 * 24 - 1, 1 })));
+    assert(!is_rejected(size + make_op(TermDeltaOpType::CURSOR, { 79, 23, 0 })));
+    assert(is_rejected(make_op(TermDeltaOpType::WIPE, { 0, 1 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::WIPE, { 0, 0xffffffff })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::WIPE, { 0, 0x100000001 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::WIPE, { 79, 2 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::WIPE, { 80 * 24, 1 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::WIPE, { 0x100000000, 1 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::WIPE, { 80 * 24 - 1, 1 }) + make_op(TermDeltaOpType::WIPE, { 0, 1 })));
+    assert(is_rejected(make_op(TermDeltaOpType::SIZE, { 0, 24 })));
+    assert(is_rejected(make_op(TermDeltaOpType::SIZE, { 0x100000050, 24 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::CURSOR, { 80, 0, 0 })));
+    assert(is_rejected(size + make_op(TermDeltaOpType::CURSOR, { 0, 0x100000000, 0 })));
+    assert(is_rejected(make_op(TermDeltaOpType::TURN, { 0x100000000 })));
+}
+
+void test_random_frames(uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    const auto random = [&rng](int n) { return static_cast<int>(rng() % n); };
+    TermDeltaEncoder encoder;
+    Screen actual;
+    Screen decoded;
+    TermDeltaDecoder decoder;
+    size_t delta_bytes = 0;
+    encoder.resize(80, 24);
+    actual.resize(80, 24);
+    for (auto frame = 0; frame < 2000; frame++) {
+        for (auto i = random(20); i > 0; i--) {
+            const auto y = random(actual.h);
+            const auto x = random(actual.w);
+            const auto n = 1 + random(actual.w - x);
+            switch (random(10)) {
+            case 0:
+                encoder.wipe(x, y, n);
+                for (auto j = 0; j < n; j++) {
+                    actual.at(x + j, y) = Cell();
+                }
+
+                break;
+            case 1: {
+                // 同じ内容の書き直しは差分にならない
+                std::string text;
+                for (auto j = 0; j < n; j++) {
+                    text.push_back(actual.at(x + j, y).c);
+                }
+
+                for (auto j = 0; j < n; j++) {
+                    encoder.put_text(x + j, y, 1, actual.at(x + j, y).a, &text[j]);
+                }
+
+                break;
+            }
+            default: {
+                const auto attr = static_cast<TERM_COLOR>(random(3) == 0 ? 0 : random(16));
+                std::string text;
+                for (auto j = 0; j < n; j++) {
+                    text.push_back(random(2) ? '#' : "abc. "[random(5)]);
+                }
+
+                encoder.put_text(x, y, n, attr, text.data());
+                for (auto j = 0; j < n; j++) {
+                    actual.at(x + j, y) = { attr, text[j] };
+                }
+
+                break;
+            }
+            }
+        }
+
+        if (random(200) == 0) {
+            encoder.clear();
+            std::fill(actual.cells.begin(), actual.cells.end(), Cell());
+        }
+
+        if (random(500) == 0) {
+            const auto w = 40 + random(120);
+            const auto h = 10 + random(40);
+            encoder.resize(w, h);
+            actual.resize(w, h);
+        }
+
+        const auto delta = encoder.encode_delta(frame);
+        delta_bytes += delta.size();
+        test_truncated_frame(delta);
+        assert(apply_stream(decoder, decoded, delta) == 1);
+        assert(decoded == actual);
+
+        // 途中から受け取る側はキーフレームだけで同じ画面になる
+        const auto keyframe = encoder.encode_keyframe(frame, frame * 10);
+        Screen from_keyframe;
+        TermDeltaDecoder keyframe_decoder;
+        assert(apply_stream(keyframe_decoder, from_keyframe, keyframe) == 1);
+        assert(from_keyframe == actual);
+    }
+
+    std::cout << "seed " << seed << ": " << delta_bytes / 2000.0 << " bytes/frame" << std::endl;
+}
+
+/*!
+ * @brief 何も変わっていないフレームは最小の大きさになることを確かめる
+ */
+void test_empty_frame()
+{
+    TermDeltaEncoder encoder;
+    encoder.resize(80, 24);
+    (void)encoder.encode_delta(0);
+    encoder.put_text(0, 0, 3, 1, "abc");
+    (void)encoder.encode_delta(1);
+    encoder.put_text(0, 0, 3, 1, "abc");
+    const auto delta = encoder.encode_delta(2);
+    assert(delta.size() == 3); // 種別, 本体の長さ, タイムスタンプ
+}
+
+/*!
+ * @brief 索引を末尾に書いた録画ファイルから索引を読み直せることを確かめる
+ */
+void test_index()
+{
+    TermDeltaEncoder encoder;
+    encoder.resize(80, 24);
+    std::string movie(TERM_DELTA_STREAM_HEADER);
+    TermDeltaIndex index;
+    for (uint32_t time = 0; time < 1000; time++) {
+        const auto text = std::to_string(time);
+        encoder.put_text(0, time % 24, text.length(), 1, text.data());
+        const auto delta = encoder.encode_delta(time);
+        if (time % 100 == 0) {
+            index.add({ time, time * 10, movie.size() });
+            movie.append(encoder.encode_keyframe(time, time * 10));
+        } else {
+            movie.append(delta);
+        }
+    }
+
+    index.set_end_time(999);
+    movie.append(index.encode_trailer(movie.size()));
+
+    const auto index_offset = TermDeltaIndex::read_footer(std::string_view(movie).substr(movie.size() - TermDeltaIndex::FOOTER_SIZE));
+    assert(index_offset);
+    assert(!TermDeltaIndex::read_footer(std::string_view(movie).substr(movie.size() - TermDeltaIndex::FOOTER_SIZE - 1, TermDeltaIndex::FOOTER_SIZE)));
+    size_t frame_size = 0;
+    const auto frame = TermDeltaDecoder::read_frame(std::string_view(movie).substr(*index_offset), frame_size);
+    assert(frame && (frame->type == TermDeltaFrameType::INDEX));
+    assert(*index_offset + frame_size + TermDeltaIndex::FOOTER_SIZE == movie.size());
+    const auto decoded = TermDeltaIndex::decode(*frame);
+    assert(decoded.get_end_time() == 999);
+    for (uint32_t time = 0; time < 1000; time++) {
+        const auto *entry = decoded.find_by_time(time);
+        assert(entry && (entry->time == time / 100 * 100) && (entry->turn == entry->time * 10));
+        assert(movie[entry->offset] == static_cast<char>(TermDeltaFrameType::KEY));
+        assert(decoded.find_by_turn(time * 10)->time == entry->time);
+    }
+
+    // 索引の指すキーフレームから再生しても、先頭から再生した場合と同じ画面になる
+    TermDeltaDecoder from_start_decoder;
+    Screen from_start;
+    apply_stream(from_start_decoder, from_start, std::string_view(movie).substr(TERM_DELTA_STREAM_HEADER.size(), *index_offset - TERM_DELTA_STREAM_HEADER.size()));
+    TermDeltaDecoder from_keyframe_decoder;
+    Screen from_keyframe;
+    const auto *last = decoded.find_by_time(999);
+    apply_stream(from_keyframe_decoder, from_keyframe, std::string_view(movie).substr(last->offset, *index_offset - last->offset));
+    assert(from_keyframe == from_start);
+}
+}
+
+int main()
+{
+    test_empty_frame();
+    test_malformed_ops();
+    test_index();
+    for (uint32_t seed = 1; seed <= 5; seed++) {
+        test_random_frames(seed);
+    }
+
+    std::cout << "All tests passed." << std::endl;
+    return 0;
+}
@@ -2,7 +2,60 @@
 #include "system/angband-exceptions.h"
 #include "term/z-rand.h"
 #include "util/string-processor.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+constexpr uint64_t MAX_TABULATED_TOTAL = UINT64_C(1) << 63; //!< 分布表を作る組み合わせ総数の上限
+constexpr int MAX_TABULATED_SUMS = 1024; //!< 分布表に含める出目の合計の種類数の上限
+constexpr int MIN_TABULATED_NUM = 5; //!< 分布表を使うダイス数の下限 (これ未満は逐次振った方が速い)
+
+/*!
+ * @brief 0以上total未満の一様乱数を返す
+ * @param total 乱数の範囲 (1以上2^63以下)
+ * @return 乱数
+ * @details 2^32以下ならゲームの乱数を1回、それを超えるなら2回使って64ビットの値を作り、偏る端数を棄却する.
+ */
+uint64_t rand_rank(uint64_t total)
+{
+    auto &rng = AngbandSystem::get_instance().get_rng();
+    if (total <= (UINT64_C(1) << 32)) {
+        return rng.bounded(static_cast<uint32_t>(total));
+    }
+
+    const auto limit = UINT64_MAX - UINT64_MAX % total;
+    while (true) {
+        const auto high = static_cast<uint64_t>(rng());
+        const auto value = (high << 32) | rng();
+        if (value < limit) {
+            return value % total;
+        }
+    }
+}
+
+/*!
+ * @brief 組み合わせの総数 sides^num を計算する
+ * @return 総数. MAX_TABULATED_TOTAL を超える場合はstd::nullopt
+ */
+std::optional<uint64_t> calc_total(int num, int sides)
+{
+    uint64_t total = 1;
+    for (auto i = 0; i < num; i++) {
+        if (total > MAX_TABULATED_TOTAL / sides) {
+            return std::nullopt;
+        }
+
+        total *= sides;
+    }
+
+    return total;
+}
+}
 
 Dice::Dice()
     : num(0)
@@ -22,9 +75,14 @@ Dice::Dice(int num, int sides)
  * @param num ダイスの数
  * @param sides ダイスの面数
  * @return 出目の合計
+ * @details ダイス数が多い場合は分布表から1回の抽選で合計を決める. 分布は1個ずつ振った場合と同一.
  */
 int Dice::roll(int num, int sides)
 {
+    if (const auto *distribution = DiceDistribution::find_for_roll(num, sides)) {
+        return distribution->roll();
+    }
+
     auto sum = 0;
     for (auto i = 0; i < num; i++) {
         sum += randint1(sides);
@@ -157,3 +215,156 @@ std::string Dice::to_string() const
 {
     return Dice::to_string(this->num, this->sides);
 }
+
+/*!
+ * @brief 分布表を作成する
+ * @param num ダイスの数
+ * @param sides ダイスの面数
+ * @throw std::invalid_argument 分布表を作れない大きさのダイスを指定した場合
+ */
+DiceDistribution::DiceDistribution(int num, int sides)
+    : num(num)
+{
+    if (!DiceDistribution::can_tabulate(num, sides)) {
+        THROW_EXCEPTION(std::invalid_argument, "Dice is too large to tabulate");
+    }
+
+    this->total = *calc_total(num, sides);
+
+    // ダイスを1個加える毎に、直前の分布と幅sidesの窓との畳み込みを取る
+    std::vector<uint64_t> counts{ 1 };
+    for (auto i = 0; i < num; i++) {
+        std::vector<uint64_t> next_counts(counts.size() + sides - 1);
+        uint64_t window = 0;
+        for (auto sum = 0; sum < std::ssize(next_counts); sum++) {
+            if (sum < std::ssize(counts)) {
+                window += counts[sum];
+            }
+
+            if ((sum >= sides) && (sum - sides < std::ssize(counts))) {
+                window -= counts[sum - sides];
+            }
+
+            next_counts[sum] = window;
+        }
+
+        counts = std::move(next_counts);
+    }
+
+    this->cumulative_counts.resize(counts.size());
+    std::partial_sum(counts.begin(), counts.end(), this->cumulative_counts.begin());
+
+    // 合計の種類数と同じ数の区間に順位を分け、各区間の先頭の順位に対応する位置を記録する
+    const auto guide_size = this->cumulative_counts.size();
+    this->guide_width = this->total / guide_size + 1;
+    this->guide.resize(guide_size);
+    // 組み合わせ総数が少ないと末尾の区間は total 以上の順位しか受け持たないため、最後の合計で打ち切る
+    const auto last_index = std::ssize(this->cumulative_counts) - 1;
+    auto index = 0;
+    for (auto i = 0; i < std::ssize(this->guide); i++) {
+        const auto first_rank = this->guide_width * i;
+        while ((index < last_index) && (this->cumulative_counts[index] <= first_rank)) {
+            index++;
+        }
+
+        this->guide[i] = index;
+    }
+}
+
+/*!
+ * @brief 分布表を作れる大きさのダイスかを返す
+ * @param num ダイスの数
+ * @param sides ダイスの面数
+ * @return 組み合わせの総数が2^63以下、かつ出目の合計の種類が上限以下ならtrue
+ */
+bool DiceDistribution::can_tabulate(int num, int sides)
+{
+    if ((num < 1) || (sides < 1)) {
+        return false;
+    }
+
+    if (static_cast<int64_t>(num) * (sides - 1) + 1 > MAX_TABULATED_SUMS) {
+        return false;
+    }
+
+    return calc_total(num, sides).has_value();
+}
+
+/*!
+ * @brief ダイスを振るのに使う分布表を取得する
+ * @param num ダイスの数
+ * @param sides ダイスの面数
+ * @return 分布表. 逐次振った方が速いか分布表を作れない場合はnullptr
+ * @details
+ * 分布表は初めて必要になった時に作成し、以後は使い回す.
+ * 排他制御をせずに済むよう、分布表はスレッド毎に持つ.
+ */
+const DiceDistribution *DiceDistribution::find_for_roll(int num, int sides)
+{
+    if ((num < MIN_TABULATED_NUM) || (sides < 2)) {
+        return nullptr;
+    }
+
+    thread_local std::map<std::pair<int, int>, std::optional<DiceDistribution>> distributions;
+    const auto key = std::make_pair(num, sides);
+    auto it = distributions.find(key);
+    if (it == distributions.end()) {
+        std::optional<DiceDistribution> distribution;
+        if (DiceDistribution::can_tabulate(num, sides)) {
+            distribution.emplace(num, sides);
+        }
+
+        it = distributions.emplace(key, std::move(distribution)).first;
+    }
+
+    return it->second ? &*it->second : nullptr;
+}
+
+/*!
+ * @brief 組み合わせの総数を返す
+ * @return sides^num
+ */
+uint64_t DiceDistribution::get_total() const
+{
+    return this->total;
+}
+
+/*!
+ * @brief 出目の合計が指定の値になる組み合わせの数を返す
+ * @param sum 出目の合計
+ * @return 組み合わせの数
+ */
+uint64_t DiceDistribution::count(int sum) const
+{
+    const auto index = sum - this->num;
+    if ((index < 0) || (index >= std::ssize(this->cumulative_counts))) {
+        return 0;
+    }
+
+    return this->cumulative_counts[index] - ((index > 0) ? this->cumulative_counts[index - 1] : 0);
+}
+
+/*!
+ * @brief 組み合わせの順位から出目の合計を求める
+ * @param rank 順位 (0以上 get_total() 未満)
+ * @return 出目の合計
+ * @details 合計の小さい組み合わせから順に順位を付けた時の、rank番目の組み合わせの合計を返す.
+ */
+int DiceDistribution::find_sum(uint64_t rank) const
+{
+    auto index = this->guide[rank / this->guide_width];
+    while (this->cumulative_counts[index] <= rank) {
+        index++;
+    }
+
+    return this->num + index;
+}
+
+/*!
+ * @brief 分布表に従って出目の合計を抽選する
+ * @return 出目の合計
+ */
+int DiceDistribution::roll() const
+{
+    return this->find_sum(rand_rank(this->total));
+}
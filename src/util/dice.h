@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <vector>
 
 class Dice {
 public:
@@ -28,3 +30,31 @@ public:
     int num; //< ダイス数
     int sides; //< ダイスの面数
 };
+
+/*!
+ * @brief ダイスの出目の合計の分布表
+ * @details
+ * 面数sidesのダイスをnum個振った全ての組み合わせ (sides^num 通り) について、出目の合計毎の組み合わせ数を
+ * 畳み込みで求めて累積しておく. 組み合わせに0から順位を付けると、順位から出目の合計が一意に決まるため、
+ * 一様な順位を1つ引くだけでダイスをnum個振った場合と全く同じ分布の合計が得られる.
+ * 順位から合計を求める探索は、順位の区間毎に探索の開始位置を記録した索引を使うことで平均O(1)で済ませる.
+ */
+class DiceDistribution {
+public:
+    DiceDistribution(int num, int sides);
+
+    static bool can_tabulate(int num, int sides);
+    static const DiceDistribution *find_for_roll(int num, int sides);
+
+    uint64_t get_total() const;
+    uint64_t count(int sum) const;
+    int find_sum(uint64_t rank) const;
+    int roll() const;
+
+private:
+    int num; //!< ダイス数
+    uint64_t total; //!< 組み合わせの総数 (sides^num)
+    std::vector<uint64_t> cumulative_counts; //!< 出目の合計がnum+i以下となる組み合わせ数
+    uint64_t guide_width; //!< 索引1つが受け持つ順位の幅
+    std::vector<int> guide; //!< 順位をguide_widthで割った値から、探索を始める cumulative_counts の位置を引く索引
+};
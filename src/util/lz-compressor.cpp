@@ -0,0 +1,217 @@
+/*!
+ * @brief LZ4ブロック形式互換の高速可逆圧縮処理の実装
+ * @details
+ * 外部ライブラリに依存しないよう、LZ4のブロック形式を最小限の機能で実装している.
+ * 1つのシーケンスは以下の形式となる.
+ * <pre>
+ * トークン(上位4bit: リテラル長, 下位4bit: 一致長-4)
+ * [リテラル長の追加バイト列(値が15以上の時のみ。255が続く限り加算)]
+ * リテラル
+ * 一致位置のオフセット(2バイト、リトルエンディアン)
+ * [一致長の追加バイト列(値が15以上の時のみ。255が続く限り加算)]
+ * </pre>
+ * 最後のシーケンスはリテラルのみで、オフセットと一致長を持たない.
+ */
+
+#include "util/lz-compressor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr size_t MIN_MATCH = 4; //!< 一致として扱う最小バイト数
+constexpr size_t LAST_LITERALS = 5; //!< 末尾で必ずリテラルとして出力するバイト数
+constexpr size_t MATCH_FIND_LIMIT = 12; //!< 一致の探索を打ち切る末尾からのバイト数
+constexpr size_t MAX_DISTANCE = 65535; //!< 一致位置として参照できる最大の距離
+constexpr auto HASH_LOG = 14;
+constexpr size_t RUN_MASK = 15;
+constexpr size_t MAX_EXPANSION_RATIO = 255; //!< 圧縮データ1バイトが展開後に表し得る最大のバイト数 (長さの追加バイト255が255バイト分を表すため)
+
+uint32_t read_u32(const uint8_t *p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t calc_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+void write_length(std::vector<uint8_t> &dst, size_t length)
+{
+    while (length >= 255) {
+        dst.push_back(255);
+        length -= 255;
+    }
+
+    dst.push_back(static_cast<uint8_t>(length));
+}
+
+void write_sequence(std::vector<uint8_t> &dst, std::span<const uint8_t> literals, size_t offset, size_t match_length)
+{
+    const auto literal_length = literals.size();
+    const auto extra_match_length = match_length - MIN_MATCH;
+    const auto token_literal = std::min(literal_length, RUN_MASK);
+    const auto token_match = (match_length == 0) ? 0 : std::min(extra_match_length, RUN_MASK);
+    dst.push_back(static_cast<uint8_t>((token_literal << 4) | token_match));
+    if (literal_length >= RUN_MASK) {
+        write_length(dst, literal_length - RUN_MASK);
+    }
+
+    dst.insert(dst.end(), literals.begin(), literals.end());
+    if (match_length == 0) {
+        return;
+    }
+
+    dst.push_back(static_cast<uint8_t>(offset & 0xFF));
+    dst.push_back(static_cast<uint8_t>((offset >> 8) & 0xFF));
+    if (extra_match_length >= RUN_MASK) {
+        write_length(dst, extra_match_length - RUN_MASK);
+    }
+}
+
+std::optional<size_t> read_length(std::span<const uint8_t> src, size_t &pos)
+{
+    size_t length = 0;
+    while (true) {
+        if (pos >= src.size()) {
+            return std::nullopt;
+        }
+
+        const auto v = src[pos++];
+        length += v;
+        if (v != 255) {
+            return length;
+        }
+    }
+}
+}
+
+namespace util {
+/*!
+ * @brief データを圧縮する
+ * @param src 圧縮するデータ
+ * @return 圧縮後のデータ
+ */
+std::vector<uint8_t> lz_compress(std::span<const uint8_t> src)
+{
+    std::vector<uint8_t> dst;
+    dst.reserve(src.size() / 2 + 16);
+    const auto size = src.size();
+    size_t anchor = 0;
+    if (size > MATCH_FIND_LIMIT) {
+        // 0 は未登録を表すため、位置+1を格納する
+        std::vector<uint32_t> hash_table(1U << HASH_LOG);
+        const auto match_limit = size - MATCH_FIND_LIMIT;
+        const auto match_end_limit = size - LAST_LITERALS;
+        size_t pos = 0;
+        while (pos < match_limit) {
+            const auto sequence = read_u32(&src[pos]);
+            auto &entry = hash_table[calc_hash(sequence)];
+            const auto candidate = static_cast<size_t>(entry);
+            entry = static_cast<uint32_t>(pos + 1);
+            if ((candidate == 0) || (pos - (candidate - 1) > MAX_DISTANCE) || (read_u32(&src[candidate - 1]) != sequence)) {
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+
+            const auto ref = candidate - 1;
+            auto match_length = MIN_MATCH;
+            while ((pos + match_length < match_end_limit) && (src[ref + match_length] == src[pos + match_length])) {
+                match_length++;
+            }
+
+            write_sequence(dst, src.subspan(anchor, pos - anchor), pos - ref, match_length);
+            pos += match_length;
+            anchor = pos;
+        }
+    }
+
+    write_sequence(dst, src.subspan(anchor), 0, 0);
+    return dst;
+}
+
+/*!
+ * @brief 圧縮データの大きさから、展開後のデータサイズとしてあり得る上限を返す
+ * @param compressed_size 圧縮データのサイズ
+ * @return 展開後のデータサイズの上限
+ * @details 壊れたデータに書かれた展開後のサイズを信じて巨大な領域を確保しないよう、確保の前にこれと比べる
+ */
+size_t lz_max_decompressed_size(size_t compressed_size)
+{
+    return compressed_size * MAX_EXPANSION_RATIO;
+}
+
+/*!
+ * @brief 圧縮されたデータを展開する
+ * @param src 圧縮されたデータ
+ * @param decompressed_size 展開後のデータサイズ
+ * @return 展開後のデータ。データが壊れていた場合はstd::nullopt
+ */
+std::optional<std::vector<uint8_t>> lz_decompress(std::span<const uint8_t> src, size_t decompressed_size)
+{
+    if (decompressed_size > lz_max_decompressed_size(src.size())) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> dst;
+    dst.reserve(decompressed_size);
+    size_t pos = 0;
+    while (pos < src.size()) {
+        const auto token = src[pos++];
+        size_t literal_length = token >> 4;
+        if (literal_length == RUN_MASK) {
+            const auto extra = read_length(src, pos);
+            if (!extra) {
+                return std::nullopt;
+            }
+
+            literal_length += *extra;
+        }
+
+        if ((literal_length > src.size() - pos) || (dst.size() + literal_length > decompressed_size)) {
+            return std::nullopt;
+        }
+
+        dst.insert(dst.end(), src.begin() + pos, src.begin() + pos + literal_length);
+        pos += literal_length;
+        if (pos == src.size()) {
+            break;
+        }
+
+        if (src.size() - pos < 2) {
+            return std::nullopt;
+        }
+
+        const size_t offset = src[pos] | (src[pos + 1] << 8);
+        pos += 2;
+        size_t match_length = token & RUN_MASK;
+        if (match_length == RUN_MASK) {
+            const auto extra = read_length(src, pos);
+            if (!extra) {
+                return std::nullopt;
+            }
+
+            match_length += *extra;
+        }
+
+        match_length += MIN_MATCH;
+        if ((offset == 0) || (offset > dst.size()) || (dst.size() + match_length > decompressed_size)) {
+            return std::nullopt;
+        }
+
+        // 一致範囲が出力中の範囲と重なり得るため1バイトずつ複写する
+        auto ref = dst.size() - offset;
+        for (size_t i = 0; i < match_length; i++) {
+            dst.push_back(dst[ref + i]);
+        }
+    }
+
+    if (dst.size() != decompressed_size) {
+        return std::nullopt;
+    }
+
+    return dst;
+}
+}
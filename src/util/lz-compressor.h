@@ -0,0 +1,16 @@
+/*!
+ * @brief LZ4ブロック形式互換の高速可逆圧縮処理の宣言
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace util {
+std::vector<uint8_t> lz_compress(std::span<const uint8_t> src);
+size_t lz_max_decompressed_size(size_t compressed_size);
+std::optional<std::vector<uint8_t>> lz_decompress(std::span<const uint8_t> src, size_t decompressed_size);
+}
@@ -1,21 +1,5 @@
 #include "util/rng-xoshiro.h"
 
-namespace {
-
-/*!
- * @brief 32ビットデータを右ローテートする
- *
- * @param x 右ローテートする32ビットデータ
- * @param k 右ローテートするビット数
- * @return xを右にkビットローテートした32ビットデータを返す
- */
-uint32_t u32b_rotl(uint32_t x, int k)
-{
-    return (x << k) | (x >> (32 - k));
-}
-
-}
-
 /*!
  * @brief デフォルトシードで乱数の内部状態を初期化したXoshiro128StarStarクラスのオブジェクトを生成する
  */
@@ -41,28 +25,27 @@ Xoshiro128StarStar::Xoshiro128StarStar(uint32_t seed)
 }
 
 /*!
- * @brief 次の乱数を生成し、内部状態を更新する
- *
- * @return 生成した乱数を返す
+ * @brief 内部状態を2^64回分進める
+ * @details 同じシードから互いに重ならない乱数列を複数作るために用いる.
+ * 多項式は xoshiro128** の参照実装 (https://prng.di.unimi.it/xoshiro128starstar.c) の jump() と同じ.
  */
-Xoshiro128StarStar::result_type Xoshiro128StarStar::operator()()
+void Xoshiro128StarStar::jump()
 {
-    auto &s = this->rng_state;
-
-    const uint32_t result = u32b_rotl(s[1] * 5, 7) * 9;
-
-    const uint32_t t = s[1] << 9;
+    constexpr std::array<uint32_t, 4> jump_polynomial{ 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    state_type jumped{};
+    for (const auto word : jump_polynomial) {
+        for (auto bit = 0; bit < 32; bit++) {
+            if (word & (1U << bit)) {
+                for (auto i = 0U; i < jumped.size(); i++) {
+                    jumped[i] ^= this->rng_state[i];
+                }
+            }
 
-    s[2] ^= s[0];
-    s[3] ^= s[1];
-    s[1] ^= s[2];
-    s[0] ^= s[3];
-
-    s[2] ^= t;
-
-    s[3] = u32b_rotl(s[3], 11);
+            (*this)();
+        }
+    }
 
-    return result;
+    this->rng_state = jumped;
 }
 
 /*!
@@ -33,6 +33,8 @@ public:
     }
 
     result_type operator()();
+    result_type bounded(result_type range);
+    void jump();
 
     void set_state(uint32_t seed);
 
@@ -42,3 +44,69 @@ public:
 private:
     state_type rng_state; //!< RNG state
 };
+
+/*!
+ * @brief 32ビットデータを左ローテートする
+ *
+ * @param x 左ローテートする32ビットデータ
+ * @param k 左ローテートするビット数
+ * @return xを左にkビットローテートした32ビットデータを返す
+ */
+constexpr uint32_t rng_xoshiro_rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+/*!
+ * @brief 次の乱数を生成し、内部状態を更新する
+ *
+ * @return 生成した乱数を返す
+ */
+inline Xoshiro128StarStar::result_type Xoshiro128StarStar::operator()()
+{
+    auto &s = this->rng_state;
+
+    const uint32_t result = rng_xoshiro_rotl(s[1] * 5, 7) * 9;
+
+    const uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+
+    s[3] = rng_xoshiro_rotl(s[3], 11);
+
+    return result;
+}
+
+/*!
+ * @brief 0以上range未満の一様乱数を生成する
+ *
+ * @param range 生成する値の個数 (0ならば32ビット全体)
+ * @return 生成した乱数を返す
+ * @details
+ * Lemire の乗算シフト法 (https://arxiv.org/abs/1805.10941) で範囲に写し、偏りの出る端数のみ棄却する.
+ * 棄却は稀なので、ほとんどの場合で除算を行わず1回の生成で済む.
+ * 処理系の分布生成器に依存しないため、同じ内部状態からはどの環境でも同じ値が得られる.
+ */
+inline Xoshiro128StarStar::result_type Xoshiro128StarStar::bounded(result_type range)
+{
+    if (range == 0) {
+        return (*this)();
+    }
+
+    auto product = static_cast<uint64_t>((*this)()) * range;
+    auto low = static_cast<uint32_t>(product);
+    if (low < range) {
+        const auto threshold = static_cast<uint32_t>(-range) % range;
+        while (low < threshold) {
+            product = static_cast<uint64_t>((*this)()) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+
+    return static_cast<result_type>(product >> 32);
+}
@@ -18,6 +18,7 @@
 #include "system/monster-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
+#include "system/rng-stream-guard.h"
 #include "system/terrain-type-definition.h"
 #include "term/term-color-types.h"
 #include "timed-effect/timed-effects.h"
@@ -133,10 +134,12 @@ static bool is_revealed_wall(const FloorType &floor, const Pos2D &pos)
  * @param player_ptr プレイヤー情報への参照ポインタ
  * @param pos 階の中の座標
  * @return シンボル表記
+ * @details 幻覚などで見た目を決める乱数は、ゲームの進行に影響しないよう演出用の乱数列から得る.
  * @todo 強力発動コピペの嵐…ポインタ引数の嵐……Fuuu^h^hck!!
  */
 DisplaySymbolPair map_info(PlayerType *player_ptr, const Pos2D &pos)
 {
+    const RngStreamGuard rng_guard(RngStream::COSMETIC);
     auto &floor = *player_ptr->current_floor_ptr;
     auto &grid = floor.get_grid(pos);
     auto &terrains = TerrainList::get_instance();
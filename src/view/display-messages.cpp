@@ -30,6 +30,9 @@ namespace {
 /*! 表示するメッセージの先頭位置 */
 static int msg_head_pos = 0;
 
+/*! 出力を保留したメッセージの格納先 (スレッド毎) */
+thread_local DeferredMessages *deferred_messages = nullptr;
+
 using msg_sp = std::shared_ptr<const std::string>;
 using msg_wp = std::weak_ptr<const std::string>;
 
@@ -280,6 +283,11 @@ static int split_length(std::string_view sv, int max)
  */
 void msg_print(std::string_view msg)
 {
+    if (deferred_messages) {
+        deferred_messages->emplace_back(msg);
+        return;
+    }
+
     const auto &world = AngbandWorld::get_instance();
     if (world.timewalk_m_idx) {
         return;
@@ -327,12 +335,17 @@ void msg_print(std::string_view msg)
     msg_head_pos += msg.size() + _(0, 1);
 
     if (fresh_message) {
-        term_fresh_force();
+        term_fresh_scheduled();
     }
 }
 
 void msg_print(std::nullptr_t)
 {
+    if (deferred_messages) {
+        deferred_messages->push_back(std::nullopt);
+        return;
+    }
+
     if (AngbandWorld::get_instance().timewalk_m_idx) {
         return;
     }
@@ -358,6 +371,32 @@ void msg_format(const char *fmt, ...)
     msg_print(buf);
 }
 
+/*!
+ * @brief 呼び出したスレッドのメッセージ出力を保留する
+ * @param messages 保留したメッセージの格納先。nullptrならば保留をやめる
+ * @details 画面に触れることのできないワーカースレッドで使用し、
+ * 保留したメッセージは後でメインスレッドから msg_print_deferred() で出力する.
+ */
+void msg_defer(DeferredMessages *messages)
+{
+    deferred_messages = messages;
+}
+
+/*!
+ * @brief 保留したメッセージを順に出力する
+ * @param messages 保留したメッセージの列
+ */
+void msg_print_deferred(const DeferredMessages &messages)
+{
+    for (const auto &msg : messages) {
+        if (msg) {
+            msg_print(*msg);
+        } else {
+            msg_print(nullptr);
+        }
+    }
+}
+
 /*!
  * @brief セーブファイルにメッセージ履歴を保存する
  */
@@ -3,8 +3,10 @@
 #include "system/angband.h"
 #include <concepts>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 /*
  * OPTION: Maximum number of messages to remember (see "io.c")
@@ -12,6 +14,12 @@
  */
 #define MESSAGE_MAX 81920
 
+/*!
+ * @brief 保留したメッセージの列
+ * @details std::nullopt は msg_print(nullptr) の呼び出しを表す.
+ */
+using DeferredMessages = std::vector<std::optional<std::string>>;
+
 extern bool msg_flag;
 extern COMMAND_CODE now_message;
 
@@ -22,5 +30,7 @@ void msg_erase();
 void msg_print(std::string_view msg);
 void msg_print(std::nullptr_t);
 void msg_format(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void msg_defer(DeferredMessages *messages);
+void msg_print_deferred(const DeferredMessages &messages);
 void wr_message_history();
 void rd_message_history();
@@ -0,0 +1,182 @@
+/*!
+ * @brief フロア生成ベンチマーク
+ * @details
+ * 画面を使わずに指定したダンジョンのフロアを繰り返し生成し、フロア毎の生成時間と統計情報をCSVに出力する.
+ * ダンジョン定義を変更した際に、生成が遅いものや再生成が多いものを見つけるために使う.
+ */
+
+#include "wizard/floor-generation-benchmark.h"
+#include "floor/floor-base-definitions.h"
+#include "floor/floor-generation-statistics.h"
+#include "floor/floor-generator.h"
+#include "room/room-types.h"
+#include "system/angband-system.h"
+#include "system/dungeon-info.h"
+#include "system/floor-type-definition.h"
+#include "system/player-type-definition.h"
+#include "util/angband-files.h"
+#include "util/string-processor.h"
+#include "view/display-messages.h"
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+const std::map<RoomType, std::string_view> ROOM_TYPE_NAMES = {
+    { RoomType::NORMAL, "normal" },
+    { RoomType::OVERLAP, "overlap" },
+    { RoomType::CROSS, "cross" },
+    { RoomType::INNER_FEAT, "inner_feat" },
+    { RoomType::NEST, "nest" },
+    { RoomType::PIT, "pit" },
+    { RoomType::LESSER_VAULT, "lesser_vault" },
+    { RoomType::GREATER_VAULT, "greater_vault" },
+    { RoomType::FRACAVE, "fracave" },
+    { RoomType::RANDOM_VAULT, "random_vault" },
+    { RoomType::OVAL, "oval" },
+    { RoomType::CRYPT, "crypt" },
+    { RoomType::TRAP_PIT, "trap_pit" },
+    { RoomType::TRAP, "trap" },
+    { RoomType::GLASS, "glass" },
+    { RoomType::ARCADE, "arcade" },
+    { RoomType::FIXED, "fixed" },
+};
+
+/*!
+ * @brief 文字列をCSVのフィールドとして引用符で囲む
+ * @param str 文字列
+ * @return 引用符で囲んだ文字列
+ */
+std::string quote_csv_field(std::string_view str)
+{
+    std::string field("\"");
+    for (const auto ch : str) {
+        field.append(ch == '"' ? 2 : 1, ch);
+    }
+
+    return field.append("\"");
+}
+
+/*!
+ * @brief 再生成の理由毎の回数をCSVのフィールドにする
+ * @param retries 再生成の理由毎の回数
+ * @return "理由:回数" を ; で連結したフィールド
+ */
+std::string build_retries_field(const std::map<std::string, int> &retries)
+{
+    std::string str;
+    for (const auto &[reason, num] : retries) {
+        str.append(str.empty() ? "" : ";").append(reason).append(":").append(std::to_string(num));
+    }
+
+    return quote_csv_field(str);
+}
+
+/*!
+ * @brief 部屋の種類毎の生成数をCSVのフィールドにする
+ * @param rooms 部屋の種類毎の生成数
+ * @return "種類:生成数" を ; で連結したフィールド
+ */
+std::string build_rooms_field(const std::map<RoomType, int> &rooms)
+{
+    std::string str;
+    for (const auto &[room_type, num] : rooms) {
+        str.append(str.empty() ? "" : ";").append(ROOM_TYPE_NAMES.at(room_type)).append(":").append(std::to_string(num));
+    }
+
+    return quote_csv_field(str);
+}
+
+/*!
+ * @brief 生成した固定部屋をCSVのフィールドにする
+ * @param vaults 生成した固定部屋の名前
+ * @return 名前を ; で連結したフィールド
+ */
+std::string build_vaults_field(const std::vector<std::string> &vaults)
+{
+    std::string str;
+    for (const auto &name : vaults) {
+        str.append(str.empty() ? "" : ";").append(name);
+    }
+
+    return quote_csv_field(str);
+}
+}
+
+/*!
+ * @brief コマンドライン引数からフロア生成ベンチマークの設定を読み取る
+ * @param arg "ダンジョンID,最も浅い階層,最も深い階層,階層毎のフロア数,シード" 形式の文字列
+ * @return 設定。形式が正しくなければstd::nullopt
+ */
+std::optional<FloorBenchmarkSetting> parse_floor_benchmark_setting(std::string_view arg)
+{
+    const auto tokens = str_split(arg, ',');
+    if (tokens.size() != 5) {
+        return std::nullopt;
+    }
+
+    try {
+        const FloorBenchmarkSetting setting{
+            static_cast<short>(std::stoi(tokens[0])),
+            std::stoi(tokens[1]),
+            std::stoi(tokens[2]),
+            std::stoi(tokens[3]),
+            static_cast<uint32_t>(std::stoul(tokens[4])),
+        };
+        if ((setting.min_depth <= 0) || (setting.min_depth > setting.max_depth) || (setting.max_depth > MAX_DEPTH - 1) || (setting.floors <= 0)) {
+            return std::nullopt;
+        }
+
+        return setting;
+    } catch (const std::exception &) {
+        return std::nullopt;
+    }
+}
+
+/*!
+ * @brief フロア生成ベンチマークを実行し、結果をCSVに出力する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param setting ベンチマークの設定
+ * @param path 出力するCSVファイルのパス
+ * @return 実行結果
+ * @details 画面が無いため、生成中のメッセージは出力せずに捨てる.
+ */
+FloorBenchmarkResultType run_floor_generation_benchmark(PlayerType *player_ptr, const FloorBenchmarkSetting &setting, const std::filesystem::path &path)
+{
+    if ((setting.dungeon_id <= 0) || (setting.dungeon_id >= std::ssize(dungeons_info)) || dungeons_info[setting.dungeon_id].name.empty()) {
+        return FloorBenchmarkResultType::INVALID_DUNGEON;
+    }
+
+    auto *fp = angband_fopen(path, FileOpenMode::WRITE);
+    if (!fp) {
+        return FloorBenchmarkResultType::FILE_OPEN_FAILED;
+    }
+
+    fputs("dungeon_id,depth,floor,time_ms,retries,retry_reasons,rooms,vaults,objects,monsters\n", fp);
+    auto &system = AngbandSystem::get_instance();
+    system.set_rng(Xoshiro128StarStar(setting.seed));
+    system.derive_rng_streams();
+    auto &floor = *player_ptr->current_floor_ptr;
+    floor.set_dungeon_index(setting.dungeon_id);
+    const auto &statistics = FloorGenerationStatistics::get_instance();
+    DeferredMessages messages;
+    msg_defer(&messages);
+    for (auto depth = setting.min_depth; depth <= setting.max_depth; depth++) {
+        floor.dun_level = depth;
+        for (auto i = 0; i < setting.floors; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            generate_floor(player_ptr);
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            messages.clear();
+            fprintf(fp, "%d,%d,%d,%.3f,%d,%s,%s,%s,%d,%d\n", setting.dungeon_id, depth, i, elapsed.count(), statistics.get_retry_count(),
+                build_retries_field(statistics.get_retries()).data(), build_rooms_field(statistics.get_rooms()).data(),
+                build_vaults_field(statistics.get_vaults()).data(), floor.o_cnt, floor.m_cnt);
+        }
+    }
+
+    msg_defer(nullptr);
+    const auto has_error = ferror(fp) != 0;
+    const auto is_closed = angband_fclose(fp) == 0;
+    return (has_error || !is_closed) ? FloorBenchmarkResultType::FILE_CLOSE_FAILED : FloorBenchmarkResultType::SUCCESSFUL;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+/*!
+ * @brief フロア生成ベンチマークの設定
+ */
+struct FloorBenchmarkSetting {
+    short dungeon_id; //!< ダンジョンID
+    int min_depth; //!< 生成する最も浅い階層
+    int max_depth; //!< 生成する最も深い階層
+    int floors; //!< 階層毎に生成するフロア数
+    uint32_t seed; //!< 乱数のシード
+};
+
+enum class FloorBenchmarkResultType {
+    SUCCESSFUL,
+    INVALID_DUNGEON,
+    FILE_OPEN_FAILED,
+    FILE_CLOSE_FAILED,
+};
+
+class PlayerType;
+std::optional<FloorBenchmarkSetting> parse_floor_benchmark_setting(std::string_view arg);
+FloorBenchmarkResultType run_floor_generation_benchmark(PlayerType *player_ptr, const FloorBenchmarkSetting &setting, const std::filesystem::path &path);